@@ -25,6 +25,7 @@
 #include "ymodem.h"
 #include "flash.h"
 #include "com.h"
+#include "hc32_ll_crc.h"
 
 /**
  * @addtogroup LL_IAP_LIB
@@ -39,6 +40,24 @@
 /*******************************************************************************
  * Local type definitions ('typedef')
  ******************************************************************************/
+/**
+ * @defgroup YMODEM_Local_Types YMODEM Local Types
+ * @{
+ */
+#if (YMODEM_RECV_DMA == DDL_ON)
+/**
+ * @brief Data packet that was ACKed but failed to program.
+ */
+typedef struct {
+    uint8_t *pu8Packet;                 /*!< Packet buffer, NULL: nothing held */
+    uint32_t u32Len;                    /*!< Data length of the packet */
+    uint32_t u32Retry;                  /*!< Program retries so far */
+    int32_t  i32Err;                    /*!< Result of the last program attempt */
+} stc_ymodem_held_t;
+#endif
+/**
+ * @}
+ */
 
 /*******************************************************************************
  * Local pre-processor symbols/macros ('#define')
@@ -61,6 +80,40 @@
 #define CONVERT_HEX_MID(c)              (IS_UPPERCASE_LETTER(c) ? ((c) - 'A' + 10) : ((c) - 'a' + 10))
 #define ASCII_CONVERT_HEX(c)            (IS_BASE_NUM(c) ? ASCII_CONVERT_DEC(c) : CONVERT_HEX_MID(c))
 
+/* CRC16 engine selected by YMODEM_CRC_MODE, the running value of the bitwise
+   engine needs CRC16_BitFinal() to become the CRC */
+#if (YMODEM_CRC_MODE == YMODEM_CRC_HW)
+#define CRC16_START()                   CRC16_HwStart()
+#define CRC16_ACCUMULATE(crc, p, n)     CRC16_HwAccumulate((crc), (p), (n))
+#define CRC16_FINAL(crc)                (crc)
+#elif (YMODEM_CRC_MODE == YMODEM_CRC_TABLE)
+#define CRC16_START()
+#define CRC16_ACCUMULATE(crc, p, n)     CRC16_TableAccumulate((crc), (p), (n))
+#define CRC16_FINAL(crc)                (crc)
+#else
+#define CRC16_START()
+#define CRC16_ACCUMULATE(crc, p, n)     CRC16_BitAccumulate((crc), (p), (n))
+#define CRC16_FINAL(crc)                CRC16_BitFinal(crc)
+#endif
+
+/* Wait for a packet, short while 'G' and 'C' are still offered in turn */
+#if (YMODEM_G_ENABLE == DDL_ON)
+#define YMODEM_RECV_WAIT(begin)         (((begin) == 0UL) ? YMODEM_G_PROBE_TIMEOUT : YMODEM_RECV_TIMEOUT)
+#else
+#define YMODEM_RECV_WAIT(begin)         (YMODEM_RECV_TIMEOUT)
+#endif
+
+/* Receive path of YModem_Receive() */
+#if (YMODEM_RECV_DMA == DDL_ON)
+#define YMODEM_RECV_START()             COM_RingStart()
+#define YMODEM_RECV_STOP()              COM_RingStop()
+#define YMODEM_RECV_DATA(p, n, t)       COM_RingRead((p), (n), (t))
+#else
+#define YMODEM_RECV_START()
+#define YMODEM_RECV_STOP()
+#define YMODEM_RECV_DATA(p, n, t)       COM_RecvData((p), (n), (t))
+#endif
+
 /**
  * @}
  */
@@ -72,6 +125,10 @@
  * @{
  */
 __ALIGN_BEGIN uint8_t u8PacketData[PACKET_STX_SIZE + PACKET_DATA_INDEX + PACKET_CRC_SIZE];
+#if (YMODEM_RECV_DMA == DDL_ON)
+/* Second receive buffer, the next packet lands here while a failed one is held */
+__ALIGN_BEGIN static uint8_t m_au8PacketSpare[PACKET_STX_SIZE + PACKET_DATA_INDEX + PACKET_CRC_SIZE];
+#endif
 /**
  * @}
  */
@@ -82,6 +139,45 @@ __ALIGN_BEGIN uint8_t u8PacketData[PACKET_STX_SIZE + PACKET_DATA_INDEX + PACKET_
  * @defgroup YMODEM_Local_Functions YMODEM Local Functions
  * @{
  */
+#if (YMODEM_CRC_MODE == YMODEM_CRC_TABLE) || (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+/* CRC16/XMODEM (0x1021, MSB first) lookup table */
+static const uint16_t m_au16Crc16Table[256] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
+    0x1231U, 0x0210U, 0x3273U, 0x2252U, 0x52B5U, 0x4294U, 0x72F7U, 0x62D6U,
+    0x9339U, 0x8318U, 0xB37BU, 0xA35AU, 0xD3BDU, 0xC39CU, 0xF3FFU, 0xE3DEU,
+    0x2462U, 0x3443U, 0x0420U, 0x1401U, 0x64E6U, 0x74C7U, 0x44A4U, 0x5485U,
+    0xA56AU, 0xB54BU, 0x8528U, 0x9509U, 0xE5EEU, 0xF5CFU, 0xC5ACU, 0xD58DU,
+    0x3653U, 0x2672U, 0x1611U, 0x0630U, 0x76D7U, 0x66F6U, 0x5695U, 0x46B4U,
+    0xB75BU, 0xA77AU, 0x9719U, 0x8738U, 0xF7DFU, 0xE7FEU, 0xD79DU, 0xC7BCU,
+    0x48C4U, 0x58E5U, 0x6886U, 0x78A7U, 0x0840U, 0x1861U, 0x2802U, 0x3823U,
+    0xC9CCU, 0xD9EDU, 0xE98EU, 0xF9AFU, 0x8948U, 0x9969U, 0xA90AU, 0xB92BU,
+    0x5AF5U, 0x4AD4U, 0x7AB7U, 0x6A96U, 0x1A71U, 0x0A50U, 0x3A33U, 0x2A12U,
+    0xDBFDU, 0xCBDCU, 0xFBBFU, 0xEB9EU, 0x9B79U, 0x8B58U, 0xBB3BU, 0xAB1AU,
+    0x6CA6U, 0x7C87U, 0x4CE4U, 0x5CC5U, 0x2C22U, 0x3C03U, 0x0C60U, 0x1C41U,
+    0xEDAEU, 0xFD8FU, 0xCDECU, 0xDDCDU, 0xAD2AU, 0xBD0BU, 0x8D68U, 0x9D49U,
+    0x7E97U, 0x6EB6U, 0x5ED5U, 0x4EF4U, 0x3E13U, 0x2E32U, 0x1E51U, 0x0E70U,
+    0xFF9FU, 0xEFBEU, 0xDFDDU, 0xCFFCU, 0xBF1BU, 0xAF3AU, 0x9F59U, 0x8F78U,
+    0x9188U, 0x81A9U, 0xB1CAU, 0xA1EBU, 0xD10CU, 0xC12DU, 0xF14EU, 0xE16FU,
+    0x1080U, 0x00A1U, 0x30C2U, 0x20E3U, 0x5004U, 0x4025U, 0x7046U, 0x6067U,
+    0x83B9U, 0x9398U, 0xA3FBU, 0xB3DAU, 0xC33DU, 0xD31CU, 0xE37FU, 0xF35EU,
+    0x02B1U, 0x1290U, 0x22F3U, 0x32D2U, 0x4235U, 0x5214U, 0x6277U, 0x7256U,
+    0xB5EAU, 0xA5CBU, 0x95A8U, 0x8589U, 0xF56EU, 0xE54FU, 0xD52CU, 0xC50DU,
+    0x34E2U, 0x24C3U, 0x14A0U, 0x0481U, 0x7466U, 0x6447U, 0x5424U, 0x4405U,
+    0xA7DBU, 0xB7FAU, 0x8799U, 0x97B8U, 0xE75FU, 0xF77EU, 0xC71DU, 0xD73CU,
+    0x26D3U, 0x36F2U, 0x0691U, 0x16B0U, 0x6657U, 0x7676U, 0x4615U, 0x5634U,
+    0xD94CU, 0xC96DU, 0xF90EU, 0xE92FU, 0x99C8U, 0x89E9U, 0xB98AU, 0xA9ABU,
+    0x5844U, 0x4865U, 0x7806U, 0x6827U, 0x18C0U, 0x08E1U, 0x3882U, 0x28A3U,
+    0xCB7DU, 0xDB5CU, 0xEB3FU, 0xFB1EU, 0x8BF9U, 0x9BD8U, 0xABBBU, 0xBB9AU,
+    0x4A75U, 0x5A54U, 0x6A37U, 0x7A16U, 0x0AF1U, 0x1AD0U, 0x2AB3U, 0x3A92U,
+    0xFD2EU, 0xED0FU, 0xDD6CU, 0xCD4DU, 0xBDAAU, 0xAD8BU, 0x9DE8U, 0x8DC9U,
+    0x7C26U, 0x6C07U, 0x5C64U, 0x4C45U, 0x3CA2U, 0x2C83U, 0x1CE0U, 0x0CC1U,
+    0xEF1FU, 0xFF3EU, 0xCF5DU, 0xDF7CU, 0xAF9BU, 0xBFBAU, 0x8FD9U, 0x9FF8U,
+    0x6E17U, 0x7E36U, 0x4E55U, 0x5E74U, 0x2E93U, 0x3EB2U, 0x0ED1U, 0x1EF0U,
+};
+#endif
+
+#if (YMODEM_CRC_MODE == YMODEM_CRC_BITWISE) || (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
 /**
  * @brief  Update CRC16 for input byte.
  * @param  crcIn                        Input value
@@ -107,6 +203,93 @@ static uint16_t CRC16_Update(uint16_t crcIn, uint8_t byte)
     return (uint16_t)(crc & 0xFFFFUL);
 }
 
+/**
+ * @brief  Bitwise CRC16 of a data block.
+ * @param  u16Crc                       Running value, 0 to start
+ * @param  pu8Data                      Pointer to the data
+ * @param  u32Len                       Data length
+ * @retval Running value, CRC16_BitFinal() gives the CRC16
+ */
+static uint16_t CRC16_BitAccumulate(uint16_t u16Crc, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    while (u32Len-- != 0UL) {
+        u16Crc = CRC16_Update(u16Crc, *pu8Data++);
+    }
+
+    return u16Crc;
+}
+
+/**
+ * @brief  Finish the bitwise CRC16 by shifting out two zero bytes.
+ * @param  u16Crc                       Running value
+ * @retval CRC16 value.
+ */
+static uint16_t CRC16_BitFinal(uint16_t u16Crc)
+{
+    u16Crc = CRC16_Update(u16Crc, 0);
+    u16Crc = CRC16_Update(u16Crc, 0);
+
+    return u16Crc;
+}
+#endif
+
+#if (YMODEM_CRC_MODE == YMODEM_CRC_TABLE) || (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Table driven CRC16 of a data block.
+ * @param  u16Crc                       Running CRC16, 0 to start
+ * @param  pu8Data                      Pointer to the data
+ * @param  u32Len                       Data length
+ * @retval CRC16 value.
+ */
+static uint16_t CRC16_TableAccumulate(uint16_t u16Crc, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    while (u32Len-- != 0UL) {
+        u16Crc = (uint16_t)(u16Crc << 8U) ^ m_au16Crc16Table[(uint8_t)(u16Crc >> 8U) ^ *pu8Data++];
+    }
+
+    return u16Crc;
+}
+#endif
+
+#if (YMODEM_CRC_MODE == YMODEM_CRC_HW) || (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Configure the CRC unit for CRC16/XMODEM.
+ * @param  None
+ * @retval None
+ * @note   The CRC unit is shared with FLASH_VerifyData(), call it before
+ *         every packet.
+ */
+static void CRC16_HwStart(void)
+{
+    stc_crc_init_t stcCrcInit;
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_CRC, ENABLE);
+    (void)CRC_StructInit(&stcCrcInit);
+    stcCrcInit.u32Protocol  = CRC_CRC16;
+    stcCrcInit.u32InitValue = 0UL;
+    stcCrcInit.u32RefIn     = CRC_REFIN_DISABLE;
+    stcCrcInit.u32RefOut    = CRC_REFOUT_DISABLE;
+    stcCrcInit.u32XorOut    = CRC_XOROUT_DISABLE;
+    (void)CRC_Init(&stcCrcInit);
+}
+
+/**
+ * @brief  CRC16 of a data block by the CRC unit.
+ * @param  u16Crc                       Running CRC16, 0 to start
+ * @param  pu8Data                      Pointer to the data
+ * @param  u32Len                       Data length
+ * @retval CRC16 value.
+ */
+static uint16_t CRC16_HwAccumulate(uint16_t u16Crc, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    if (u32Len != 0UL) {
+        (void)CRC_CRC16_Calculate(u16Crc, CRC_DATA_WIDTH_8BIT, pu8Data, u32Len, &u16Crc);
+    }
+
+    return u16Crc;
+}
+#endif
+
 /**
  * @brief  Cal CRC16 for YModem Packet.
  * @param  pu8Data
@@ -115,16 +298,12 @@ static uint16_t CRC16_Update(uint16_t crcIn, uint8_t byte)
  */
 static uint16_t CRC16_CalData(const uint8_t *pu8Data, uint32_t size)
 {
-    uint16_t crc = 0U;
-    const uint8_t *dataEnd = pu8Data + size;
+    uint16_t crc;
 
-    while (pu8Data < dataEnd) {
-        crc = CRC16_Update(crc, *pu8Data++);
-    }
-    crc = CRC16_Update(crc, 0);
-    crc = CRC16_Update(crc, 0);
+    CRC16_START();
+    crc = CRC16_ACCUMULATE(0U, pu8Data, size);
 
-    return crc & 0xFFFFU;
+    return CRC16_FINAL(crc);
 }
 
 /**
@@ -211,12 +390,14 @@ static void Prepare_Packet(uint8_t *pu8Src, uint8_t *pu8Packet, uint8_t u8Num, u
 static int32_t ReceivePacket(uint8_t *pu8Data, uint32_t *pu32Len, uint32_t timeout)
 {
     uint32_t u32Crc;
+    uint32_t u32Pos;
     uint32_t packetSize = PACKET_END_TRANS;
     int32_t i32Ret;
+    uint16_t u16Crc = 0U;
     uint8_t u8Temp;
 
     *pu32Len = 0;
-    i32Ret = COM_RecvData(&u8Temp, 1, timeout);
+    i32Ret = YMODEM_RECV_DATA(&u8Temp, 1, timeout);
     if (i32Ret == LL_OK) {
         switch (u8Temp) {
             case YMODEM_SOH:
@@ -228,7 +409,7 @@ static int32_t ReceivePacket(uint8_t *pu8Data, uint32_t *pu32Len, uint32_t timeo
             case YMODEM_EOT:
                 break;
             case YMODEM_CAN:
-                if ((COM_RecvData(&u8Temp, 1, timeout) == LL_OK) && (u8Temp == YMODEM_CAN)) {
+                if ((YMODEM_RECV_DATA(&u8Temp, 1, timeout) == LL_OK) && (u8Temp == YMODEM_CAN)) {
                     packetSize = PACKET_ABORT_SENDER;
                 } else {
                     i32Ret = LL_ERR;
@@ -244,7 +425,19 @@ static int32_t ReceivePacket(uint8_t *pu8Data, uint32_t *pu32Len, uint32_t timeo
         }
         pu8Data[PACKET_START_INDEX] = u8Temp;
         if (packetSize >= PACKET_SOH_SIZE) {
-            i32Ret = COM_RecvData(&pu8Data[PACKET_NUM_INDEX], (uint16_t)packetSize + PACKET_OVERHEAD_SIZE, timeout);
+            i32Ret = YMODEM_RECV_DATA(&pu8Data[PACKET_NUM_INDEX], PACKET_HEAD_SIZE - 1U, timeout);
+            /* Data in YMODEM_RECV_CHUNK steps, the CRC of a step is done before the next is read */
+            CRC16_START();
+            for (u32Pos = PACKET_DATA_INDEX; (i32Ret == LL_OK) && (u32Pos < (packetSize + PACKET_DATA_INDEX));
+                 u32Pos += YMODEM_RECV_CHUNK) {
+                i32Ret = YMODEM_RECV_DATA(&pu8Data[u32Pos], YMODEM_RECV_CHUNK, timeout);
+                if (i32Ret == LL_OK) {
+                    u16Crc = CRC16_ACCUMULATE(u16Crc, &pu8Data[u32Pos], YMODEM_RECV_CHUNK);
+                }
+            }
+            if (i32Ret == LL_OK) {
+                i32Ret = YMODEM_RECV_DATA(&pu8Data[packetSize + PACKET_DATA_INDEX], PACKET_CRC_SIZE, timeout);
+            }
             /* Packet sanity check */
             if (i32Ret == LL_OK) {
                 if (pu8Data[PACKET_NUM_INDEX] != ((pu8Data[PACKET_XORNUM_INDEX]) ^ YMODEM_NUM_XOR_BYTE)) {
@@ -254,7 +447,7 @@ static int32_t ReceivePacket(uint8_t *pu8Data, uint32_t *pu32Len, uint32_t timeo
                     /* Check packet CRC */
                     u32Crc = (uint32_t)pu8Data[packetSize + PACKET_DATA_INDEX] << 8UL;
                     u32Crc += pu8Data[packetSize + PACKET_DATA_INDEX + 1UL];
-                    if (CRC16_CalData(&pu8Data[PACKET_DATA_INDEX], packetSize) != u32Crc) {
+                    if (CRC16_FINAL(u16Crc) != u32Crc) {
                         packetSize = PACKET_END_TRANS;
                         i32Ret = LL_ERR;
                     }
@@ -268,6 +461,39 @@ static int32_t ReceivePacket(uint8_t *pu8Data, uint32_t *pu32Len, uint32_t timeo
 
     return i32Ret;
 }
+#if (YMODEM_RECV_DMA == DDL_ON)
+/**
+ * @brief  Retry the program of a held packet, its result answers the packet
+ *         just received (deferred NAK).
+ * @param  pstcHeld                     Held packet
+ * @param  pu32Addr                     Flash address of the held packet, advanced on success
+ * @retval uint8_t:
+ *           - YMODEM_ACK: Nothing held any more
+ *           - YMODEM_NAK: EFM still busy, have the packet just received sent again
+ *           - YMODEM_CAN: Give up
+ * @note   Only LL_ERR_NOT_RDY is retried, after any other error the range may be
+ *         partly programmed.
+ */
+static uint8_t ProgramHeldPacket(stc_ymodem_held_t *pstcHeld, __IO uint32_t *pu32Addr)
+{
+    if (pstcHeld->pu8Packet == NULL) {
+        return YMODEM_ACK;
+    }
+    if (pstcHeld->i32Err == LL_ERR_NOT_RDY) {
+        pstcHeld->i32Err = FLASH_WriteData(*pu32Addr, &pstcHeld->pu8Packet[PACKET_DATA_INDEX], pstcHeld->u32Len);
+        if (pstcHeld->i32Err == LL_OK) {
+            *pu32Addr += pstcHeld->u32Len;
+            pstcHeld->pu8Packet = NULL;
+            return YMODEM_ACK;
+        }
+    }
+    if ((pstcHeld->i32Err != LL_ERR_NOT_RDY) || (++pstcHeld->u32Retry > YMODEM_MAX_ERR)) {
+        return YMODEM_CAN;
+    }
+
+    return YMODEM_NAK;
+}
+#endif
 /**
  * @}
  */
@@ -521,18 +747,29 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
     uint32_t sessionBegin = 0, sessionDone = 0, fileDone;
     uint32_t fileSize, packetCnt;
     uint8_t *filePtr;
+    uint8_t *pu8Packet = u8PacketData;
     uint8_t fileSizeStr[FILE_SIZE_LEN], temp;
     int32_t i32Ret = YMODEM_COM_OK;
+#if (YMODEM_RECV_DMA == DDL_ON)
+    stc_ymodem_held_t stcHeld = {NULL, 0UL, 0UL, LL_OK};
+#endif
+#if (YMODEM_G_ENABLE == DDL_ON)
+    /* Offer 'G' and 'C' in turn until a header arrives, the one it answered stays selected */
+    uint8_t u8Request = YMODEM_G;
+#else
+    uint8_t u8Request = YMODEM_CRC16;
+#endif
 
     /* Initialize appFlashAddr variable */
     appFlashAddr = IAP_APP_ADDR;
+    YMODEM_RECV_START();
     while ((sessionDone == 0UL) && (i32Ret == YMODEM_COM_OK)) 
     {
         packetCnt = 0;
         fileDone = 0;
         while ((fileDone == 0UL) && (i32Ret == YMODEM_COM_OK)) 
         {
-            switch (ReceivePacket(u8PacketData, &packetLen, YMODEM_RECV_TIMEOUT)) 
+            switch (ReceivePacket(pu8Packet, &packetLen, YMODEM_RECV_WAIT(sessionBegin))) 
             {
                 case LL_OK:
                     errCnt = 0;
@@ -544,15 +781,39 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                             i32Ret = YMODEM_COM_ABORT;
                             break;
                         case 0: /* End of transmission */
+#if (YMODEM_RECV_DMA == DDL_ON)
+                            temp = ProgramHeldPacket(&stcHeld, &appFlashAddr);
+                            if (temp != YMODEM_ACK)
+                            {
+                                COM_SendData(&temp, 1);
+                                if (temp == YMODEM_CAN)
+                                {
+                                    COM_SendData(&temp, 1);
+                                    i32Ret = YMODEM_COM_FLASH_ERR;
+                                }
+                                break;
+                            }
+#endif
                             temp = YMODEM_ACK;
                             COM_SendData(&temp, 1);
                             fileDone = 1;
                             i = APP_EXIST_FLAG;
                             (void)FLASH_WriteData(APP_EXIST_FLAG_ADDR, (uint8_t *)&i, 4U);
+                            COM_SendData(&u8Request, 1);    /* Ask for the next file header */
                             break;
                         default: /* Normal packet */
-                            if (u8PacketData[PACKET_NUM_INDEX] != (uint8_t)packetCnt) 
+                            if (pu8Packet[PACKET_NUM_INDEX] != (uint8_t)packetCnt) 
                             {
+#if (YMODEM_G_ENABLE == DDL_ON)
+                                if ((u8Request == YMODEM_G) && (packetCnt != 0UL))
+                                {   /* No retransmission while streaming */
+                                    temp = YMODEM_CAN;
+                                    COM_SendData(&temp, 1);
+                                    COM_SendData(&temp, 1);
+                                    i32Ret = YMODEM_COM_ERR;
+                                    break;
+                                }
+#endif
                                 temp = YMODEM_NAK;
                                 COM_SendData(&temp, 1);
                             } 
@@ -561,11 +822,11 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                                 if (packetCnt == 0UL) 
                                 {
                                     /* File name packet */
-                                    if (u8PacketData[PACKET_DATA_INDEX] != 0U) 
+                                    if (pu8Packet[PACKET_DATA_INDEX] != 0U) 
                                     {
                                         /* File name extraction */
                                         i = 0;
-                                        filePtr = u8PacketData + PACKET_DATA_INDEX;
+                                        filePtr = pu8Packet + PACKET_DATA_INDEX;
                                         while ((*filePtr != 0U) && (i < FILE_NAME_LEN)) 
                                         {
                                             pu8FileName[i++] = *filePtr++;
@@ -596,8 +857,7 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                                             *pu32Size = fileSize;
                                             temp = YMODEM_ACK;
                                             COM_SendData(&temp, 1);
-                                            temp = YMODEM_CRC16;
-                                            COM_SendData(&temp, 1);
+                                            COM_SendData(&u8Request, 1);
                                         }
                                     } 
                                     else 
@@ -611,7 +871,52 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                                 }
                                 else
                                 { /* Data packet */
-                                    if (FLASH_WriteData(appFlashAddr, &u8PacketData[PACKET_DATA_INDEX], packetLen) == LL_OK) 
+#if (YMODEM_G_ENABLE == DDL_ON)
+                                    if (u8Request == YMODEM_G)
+                                    {   /* Streaming: no ACK, the transfer is aborted on the first error */
+                                        if (FLASH_WriteData(appFlashAddr, &pu8Packet[PACKET_DATA_INDEX], packetLen) != LL_OK)
+                                        {
+                                            temp = YMODEM_CAN;
+                                            COM_SendData(&temp, 1);
+                                            COM_SendData(&temp, 1);
+                                            i32Ret = YMODEM_COM_FLASH_ERR;
+                                            break;
+                                        }
+                                        appFlashAddr += packetLen;
+                                        packetCnt++;
+                                        break;
+                                    }
+#endif
+#if (YMODEM_RECV_DMA == DDL_ON)
+                                    /* A held packet is retried first, its result answers this one */
+                                    temp = ProgramHeldPacket(&stcHeld, &appFlashAddr);
+                                    if (temp != YMODEM_ACK)
+                                    {
+                                        COM_SendData(&temp, 1);
+                                        if (temp == YMODEM_CAN)
+                                        {
+                                            COM_SendData(&temp, 1);
+                                            i32Ret = YMODEM_COM_FLASH_ERR;
+                                        }
+                                        break;
+                                    }
+                                    /* ACK at once, the next packet streams into the RX ring while this one is programmed */
+                                    COM_SendData(&temp, 1);
+                                    stcHeld.i32Err = FLASH_WriteData(appFlashAddr, &pu8Packet[PACKET_DATA_INDEX], packetLen);
+                                    if (stcHeld.i32Err == LL_OK)
+                                    {
+                                        appFlashAddr += packetLen;
+                                    }
+                                    else
+                                    {   /* Reported when the next packet arrives */
+                                        stcHeld.pu8Packet = pu8Packet;
+                                        stcHeld.u32Len = packetLen;
+                                        stcHeld.u32Retry = 0UL;
+                                    }
+                                    /* Receive into the other buffer, a held packet stays intact */
+                                    pu8Packet = (pu8Packet == u8PacketData) ? m_au8PacketSpare : u8PacketData;
+#else
+                                    if (FLASH_WriteData(appFlashAddr, &pu8Packet[PACKET_DATA_INDEX], packetLen) == LL_OK) 
                                     {
                                         appFlashAddr += packetLen;
                                         temp = YMODEM_ACK;
@@ -624,6 +929,7 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                                         COM_SendData(&temp, 1);
                                         i32Ret = YMODEM_COM_FLASH_ERR;
                                     }
+#endif
                                 }
                                 packetCnt++;
                                 sessionBegin = 1;
@@ -638,6 +944,20 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                     i32Ret = YMODEM_COM_ABORT;
                     break;
                 default:
+#if (YMODEM_G_ENABLE == DDL_ON)
+                    if ((u8Request == YMODEM_G) && (packetCnt != 0UL))
+                    {   /* Bad or missing packet while streaming */
+                        temp = YMODEM_CAN;
+                        COM_SendData(&temp, 1);
+                        COM_SendData(&temp, 1);
+                        i32Ret = YMODEM_COM_ERR;
+                        break;
+                    }
+                    if (sessionBegin == 0UL)
+                    {   /* No answer yet, the sender may start late or know only one of them */
+                        u8Request = (u8Request == YMODEM_G) ? YMODEM_CRC16 : YMODEM_G;
+                    }
+#endif
                     if (sessionBegin > 0UL) 
                     {
                         errCnt++;
@@ -650,16 +970,63 @@ int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size)
                     } 
                     else 
                     {
-                        temp = YMODEM_CRC16;  /* Ask for a packet */
-                        COM_SendData(&temp, 1);
+                        COM_SendData(&u8Request, 1);  /* Ask for a packet */
                     }
                     break;
             }
         }
     }
 
+    YMODEM_RECV_STOP();
+
     return i32Ret;
 }
+
+#if (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Measure the three CRC16 engines over one STX packet.
+ * @param  pu32BitCycle                 HCLK cycles of the bitwise engine
+ * @param  pu32TableCycle               HCLK cycles of the table engine
+ * @param  pu32HwCycle                  HCLK cycles of the CRC unit
+ * @retval int32_t:
+ *           - LL_OK: All engines gave the same CRC16
+ *           - LL_ERR: The engines disagree
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ * @note   The DWT cycle counter must be running. u8PacketData is used as
+ *         scratch, do not call it during a transfer.
+ */
+int32_t YModem_CrcBenchmark(uint32_t *pu32BitCycle, uint32_t *pu32TableCycle, uint32_t *pu32HwCycle)
+{
+    const uint8_t *pu8Data = &u8PacketData[PACKET_DATA_INDEX];
+    uint32_t i;
+    uint32_t u32Cycle;
+    uint16_t u16BitCrc;
+    uint16_t u16TableCrc;
+    uint16_t u16HwCrc;
+
+    if ((pu32BitCycle == NULL) || (pu32TableCycle == NULL) || (pu32HwCycle == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+    for (i = 0UL; i < PACKET_STX_SIZE; i++) {
+        u8PacketData[PACKET_DATA_INDEX + i] = (uint8_t)((i * 7UL) + 1UL);
+    }
+
+    u32Cycle = DWT->CYCCNT;
+    u16BitCrc = CRC16_BitFinal(CRC16_BitAccumulate(0U, pu8Data, PACKET_STX_SIZE));
+    *pu32BitCycle = DWT->CYCCNT - u32Cycle;
+
+    u32Cycle = DWT->CYCCNT;
+    u16TableCrc = CRC16_TableAccumulate(0U, pu8Data, PACKET_STX_SIZE);
+    *pu32TableCycle = DWT->CYCCNT - u32Cycle;
+
+    CRC16_HwStart();
+    u32Cycle = DWT->CYCCNT;
+    u16HwCrc = CRC16_HwAccumulate(0U, pu8Data, PACKET_STX_SIZE);
+    *pu32HwCycle = DWT->CYCCNT - u32Cycle;
+
+    return ((u16BitCrc == u16TableCrc) && (u16BitCrc == u16HwCrc)) ? LL_OK : LL_ERR;
+}
+#endif /* YMODEM_CRC_BENCH_ENABLE */
 /**
  * @}
  */
@@ -87,6 +87,7 @@ extern "C"
 #define YMODEM_NAK                      (0x15U) /* Negative acknowledge */
 #define YMODEM_CAN                      (0x18U) /* Two of these in succession aborts transfer */
 #define YMODEM_CRC16                    (0x43U) /* 'C' == 0x43, request 16-bit CRC */
+#define YMODEM_G                        (0x47U) /* 'G' == 0x47, request streaming (YModem-G) */
 #define YMODEM_NUM_XOR_BYTE             (0xFFU)
 
 #define YMODEM_ABORT1                   (0x41U)  /* 'A' == 0x41, abort by user */
@@ -97,6 +98,39 @@ extern "C"
 #define YMODEM_RECV_TIMEOUT             (5000U) /* Five second retry delay */
 #define YMODEM_RECV_WAITFOREVER         (0xFFFFFFFFUL)
 
+/* CRC16 engine of the packet check */
+#define YMODEM_CRC_BITWISE              (0U)    /* Bit-serial loop */
+#define YMODEM_CRC_TABLE                (1U)    /* 256-entry lookup table */
+#define YMODEM_CRC_HW                   (2U)    /* CRC unit, shared with the flash verify */
+#ifndef YMODEM_CRC_MODE
+#define YMODEM_CRC_MODE                 (YMODEM_CRC_HW)
+#endif
+
+/* YModem_Receive() over the RX DMA ring: data packets are ACKed once their CRC
+   passes and programmed while the next one arrives. DDL_OFF: polled, program then ACK */
+#ifndef YMODEM_RECV_DMA
+#define YMODEM_RECV_DMA                 (DDL_ON)
+#endif
+
+/* YModem_Receive() offers YModem-G and 'C' in turn until the first header.
+   YModem-G: no ACK per data packet, any error cancels the transfer. Needs the
+   DMA receive path */
+#ifndef YMODEM_G_ENABLE
+#define YMODEM_G_ENABLE                 (YMODEM_RECV_DMA)
+#endif
+#if (YMODEM_G_ENABLE == DDL_ON) && (YMODEM_RECV_DMA != DDL_ON)
+#error "YMODEM_G_ENABLE requires YMODEM_RECV_DMA"
+#endif
+#define YMODEM_G_PROBE_TIMEOUT          (1000U)     /* ms per 'G'/'C' offer before the first header */
+
+/* Receive step of the packet data, the CRC runs between steps. Must divide PACKET_SOH_SIZE */
+#define YMODEM_RECV_CHUNK               (128U)
+
+/* CRC16 engine benchmark On/Off */
+#ifndef YMODEM_CRC_BENCH_ENABLE
+#define YMODEM_CRC_BENCH_ENABLE         (DDL_OFF)
+#endif
+
 /**
  * @}
  */
@@ -115,6 +149,9 @@ void YModem_Int2Str(uint8_t *pu8Str, uint32_t u32Value);
 int32_t YModem_Str2Int(uint32_t *pu32Value, uint8_t *pu8Str);
 int32_t YModem_Receive(uint8_t *pu8FileName, uint32_t *pu32Size);
 int32_t YModem_Transmit(uint8_t *pu8Buf, const uint8_t *pu8FileName, uint32_t fileSize);
+#if (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+int32_t YModem_CrcBenchmark(uint32_t *pu32BitCycle, uint32_t *pu32TableCycle, uint32_t *pu32HwCycle);
+#endif
 /**
  * @}
  */
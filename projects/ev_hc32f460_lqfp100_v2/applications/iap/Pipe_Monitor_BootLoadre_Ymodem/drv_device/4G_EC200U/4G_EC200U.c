@@ -20,6 +20,7 @@
 #include "stdlib.h"
 #include "time.h"
 #include "flash.h"
+#include "image.h"
 #include "main.h"
 #include "Display.h"
 #include "time.h"
@@ -219,6 +220,8 @@ uint8_t func_Publish_Topic_DataPt_Cmd(void)
     usRecvTimeOutCnt = 0;
     while((m_RecvFlag == 0))
     {
+        BSP_W25QXX_PowerTask();
+        func_UI_Task();
         DDL_DelayMS(20);
         usRecvTimeOutCnt++;
         if(usRecvTimeOutCnt >= 500)
@@ -509,6 +512,8 @@ uint8_t EC200U_4G_Module_Configuration_Init(void)
         usRecvTimeOutCnt = 0;
         while(m_RecvFlag == 0)
         {
+            BSP_W25QXX_PowerTask();
+            func_UI_Task();
             DDL_DelayMS(20);
             usRecvTimeOutCnt++;
             if(usRecvTimeOutCnt >= 100)
@@ -547,6 +552,10 @@ uint8_t EC200U_4G_Module_Configuration_Init(void)
         if(func_Array_Find_Str((char *)m_au8RxBuf,m_u16RxLen,(char *)ucRecvCheckData,strlen((char*)ucRecvCheckData), &usDataPosi) == 0) //接收到的数据中包含OK
         {
             #if 1
+            if(gE_4G_Module_Init_CMD == Module_QUERY_SIGNAL_STRENGTH_CMD)
+            {
+                func_UI_Post_Rssi((unsigned char)atoi((char *)&m_au8RxBuf[usDataPosi + 5]));   //+CSQ: <rssi>,<ber>
+            }
             if(gE_4G_Module_Init_CMD == Module_PUBLISH_TOPIC_UPGRADECHECK_CMD)
             {
                 if(func_Array_Find_Str((char *)m_au8RxBuf,m_u16RxLen,"\"res\":0",7, &usDataPosi) == 0)
@@ -684,6 +693,8 @@ uint8_t EC200U_4G_Module_Init(void)
         usRecvTimeOutCnt = 0;
         while(m_RecvFlag == 0)
         {
+            BSP_W25QXX_PowerTask();
+            func_UI_Task();
             SysTick_Delay(10);
             usRecvTimeOutCnt++;
             if(usRecvTimeOutCnt >= 1500)
@@ -746,9 +757,7 @@ unsigned char func_4G_Module_Connect_HTTP(unsigned char* ucURLArr, uint16_t usUR
     unsigned short j = 0;
     unsigned char ucFlag = 0;
     uint8_t ucDataLenArr[10] = {0}; //用于存储数据长度
-    __IO uint32_t appFlashAddr;
-
-    appFlashAddr = IAP_APP_ADDR;
+    stc_image_stage_t stcStage = {0UL, 0UL, 0UL, 0UL};
 
     //拉低4G模块电源引脚2s以上，让4G模块开机
     GPIO_ResetPins(EC200U_4G_MODULE_PWRKEY_PORT, EC200U_4G_MODULE_PWRKEY_PIN);
@@ -763,6 +772,8 @@ unsigned char func_4G_Module_Connect_HTTP(unsigned char* ucURLArr, uint16_t usUR
     usRecvTimeOutCnt = 0;
     while(m_RecvFlag == 0)
     {
+        BSP_W25QXX_PowerTask();
+        func_UI_Task();
         SysTick_Delay(10);
         usRecvTimeOutCnt++;
         if(usRecvTimeOutCnt >= 1500)
@@ -879,11 +890,10 @@ unsigned char func_4G_Module_Connect_HTTP(unsigned char* ucURLArr, uint16_t usUR
             gul_IAP_Upgrade_Total_Size = ulDataTotalSize; //保存升级文件总大小
             usSendDataLen = strlen((char *)ucSendBuf);
             sprintf((char *)ucRecvCheckData, "OK");
-            if (ulDataTotalSize < IAP_APP_SIZE) 
+            /* Stage in the W25Q128, the running application stays intact until the image is complete */
+            if ((ulDataTotalSize >= IAP_APP_SIZE) || (IMAGE_StageOpen(&stcStage, ulDataTotalSize, 0UL) != LL_OK))
             {
-                /* Erase user application area */
-                (void)FLASH_EraseSector(IAP_APP_ADDR, ulDataTotalSize);
-                (void)FLASH_EraseSector(APP_EXIST_FLAG_ADDR, 0U);
+                return 4;   //镜像过大或暂存区打开失败
             }
             break;
         case Module_FILE_QFREAD: //读取文件
@@ -917,6 +927,8 @@ unsigned char func_4G_Module_Connect_HTTP(unsigned char* ucURLArr, uint16_t usUR
         usRecvTimeOutCnt = 0;
         while(m_RecvFlag == 0)
         {
+            BSP_W25QXX_PowerTask();
+            func_UI_Task();
             DDL_DelayMS(20);
             usRecvTimeOutCnt++;
             if(usRecvTimeOutCnt >= 100)
@@ -1011,16 +1023,19 @@ unsigned char func_4G_Module_Connect_HTTP(unsigned char* ucURLArr, uint16_t usUR
             }
             else if(gE_4G_Module_Connect_HTTP_CMD == Module_FILE_QFREAD)
             {
-                if (FLASH_WriteData(appFlashAddr, &m_au8RxBuf[0], ulDataLen) == LL_OK) 
+                if (IMAGE_StageAppend(&stcStage, &m_au8RxBuf[0], ulDataLen) != LL_OK)
                 {
-                    appFlashAddr += ulDataLen;
-                } 
+                    return 4;   //写入暂存区失败
+                }
                 ulDataStartPosi += ulDataLen;
                 gul_IAP_Upgrade_Current_Size = ulDataStartPosi; //保存当前升级文件已下载大小
                 if(ulDataStartPosi >= ulDataTotalSize) //数据读取完成
                 {
-                    i = APP_EXIST_FLAG;
-                    (void)FLASH_WriteData(APP_EXIST_FLAG_ADDR, (uint8_t *)&i, 4U);
+                    //校验暂存镜像并拷贝到内部Flash
+                    if ((IMAGE_StageClose(&stcStage) != LL_OK) || (IMAGE_InstallPending() != LL_OK))
+                    {
+                        return 4;
+                    }
                     gE_4G_Module_Connect_HTTP_CMD++; //进入关闭HTTP连接状态
                 }
                 else
@@ -1028,7 +1043,7 @@ unsigned char func_4G_Module_Connect_HTTP(unsigned char* ucURLArr, uint16_t usUR
                     ulDataLen = (ulDataTotalSize - ulDataStartPosi > 1024) ? 1024 : (ulDataTotalSize - ulDataStartPosi);
                     gE_4G_Module_Connect_HTTP_CMD = Module_FILE_QFREAD; //继续获取数据
                 }
-                func_Device_Upgrade_View_Show();
+                func_UI_Post_Progress(ulDataStartPosi, ulDataTotalSize);   //界面由 func_UI_Task 限速刷新
                 ucRetryCnt = 0;
             }
             else
@@ -1080,6 +1095,8 @@ unsigned char func_4G_Up_Upgrade_Result(unsigned char ucResult)
     usRecvTimeOutCnt = 0;
     while(m_RecvFlag == 0)
     {
+        BSP_W25QXX_PowerTask();
+        func_UI_Task();
         SysTick_Delay(10);
         usRecvTimeOutCnt++;
         if(usRecvTimeOutCnt >= 1500)
@@ -1229,6 +1246,8 @@ unsigned char func_4G_Up_Upgrade_Result(unsigned char ucResult)
         usRecvTimeOutCnt = 0;
         while(m_RecvFlag == 0)
         {
+            BSP_W25QXX_PowerTask();
+            func_UI_Task();
             DDL_DelayMS(20);
             usRecvTimeOutCnt++;
             if(usRecvTimeOutCnt >= 100)
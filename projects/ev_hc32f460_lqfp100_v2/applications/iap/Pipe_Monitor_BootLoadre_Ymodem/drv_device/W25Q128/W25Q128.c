@@ -15,6 +15,7 @@
  * Include files
  ******************************************************************************/
 #include "W25Q128.h"
+#include "main.h"
 #include "string.h"
 #include "stdio.h"
 #include "stdlib.h"
@@ -31,6 +32,21 @@ static void BSP_SPI_Active(void);
 static void BSP_SPI_Inactive(void);
 static int32_t BSP_SPI_Trans(const uint8_t *pu8TxBuf, uint32_t u32Size);
 static int32_t BSP_SPI_Receive(uint8_t *pu8RxBuf, uint32_t u32Size);
+static void BSP_SPI_Config(uint32_t u32BaudRate, uint32_t u32IntervalDelay, uint32_t u32ReleaseDelay);
+static void BSP_SPI_DmaInit(void);
+static void BSP_SPI_DmaDeInit(void);
+static void BSP_SPI_DmaArm(const uint8_t *pu8TxBuf, uint8_t *pu8RxBuf, uint32_t u32Count);
+static void BSP_SPI_DmaPrepare(const uint8_t *pu8TxBuf, uint32_t u32Size);
+static void BSP_SPI_DmaStart(void);
+static int32_t BSP_SPI_DmaWait(uint32_t u32Count);
+static int32_t BSP_SPI_DmaRun(const uint8_t *pu8TxBuf, uint8_t *pu8RxBuf, uint32_t u32Size);
+static int32_t BSP_SPI_DmaTrans(const uint8_t *pu8TxBuf, uint32_t u32Size);
+static int32_t BSP_SPI_DmaReceive(uint8_t *pu8RxBuf, uint32_t u32Size);
+static uint32_t BSP_SPI_GetSckFreq(void);
+static int32_t BSP_W25QXX_Wake(void);
+static int32_t BSP_W25QXX_ReadDirect(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteToRead);
+static void BSP_W25QXX_CacheDrop(uint32_t u32Addr, uint32_t u32Size);
+static void BSP_W25QXX_CacheUpdate(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32Size);
 /**
  * @}
  */
@@ -44,19 +60,95 @@ static int32_t BSP_SPI_Receive(uint8_t *pu8RxBuf, uint32_t u32Size);
  */
 static stc_w25qxx_ll_t m_stcW25qxxLL = {
     .Delay    = DDL_DelayMS,
+    .DelayUs  = DDL_DelayUS,
     .Init     = BSP_SPI_Init,
     .DeInit   = BSP_SPI_DeInit,
     .Active   = BSP_SPI_Active,
     .Inactive = BSP_SPI_Inactive,
     .Trans    = BSP_SPI_Trans,
     .Receive  = BSP_SPI_Receive,
+    .GetSckFreq = BSP_SPI_GetSckFreq,
 };
+
+static stc_w25qxx_ll_t m_stcW25qxxDmaLL = {
+    .Delay    = DDL_DelayMS,
+    .DelayUs  = DDL_DelayUS,
+    .Init     = BSP_SPI_DmaInit,
+    .DeInit   = BSP_SPI_DmaDeInit,
+    .Active   = BSP_SPI_Active,
+    .Inactive = BSP_SPI_Inactive,
+    .Trans    = BSP_SPI_DmaTrans,
+    .Receive  = BSP_SPI_DmaReceive,
+    .GetSckFreq = BSP_SPI_GetSckFreq,
+    .Prepare  = BSP_SPI_DmaPrepare,
+};
+
+/* Transport used by the BSP_W25QXX_xxx() functions */
+#if (BSP_W25QXX_TRANS_DEFAULT == BSP_W25QXX_TRANS_DMA)
+static stc_w25qxx_ll_t *m_pstcW25qxxLL = &m_stcW25qxxDmaLL;
+#else
+static stc_w25qxx_ll_t *m_pstcW25qxxLL = &m_stcW25qxxLL;
+#endif
+
+#if (W25QXX_CACHE_SECTOR_NUM > 0U)
+/* Write-through read cache of whole 4KB sectors, LRU replacement */
+static struct {
+    uint32_t u32Addr;                   /* Sector base address */
+    uint32_t u32Stamp;                  /* Last use, 0: empty */
+    uint8_t au8Data[W25Q128_SECTOR_SIZE];
+} m_astcCache[W25QXX_CACHE_SECTOR_NUM];
+static uint32_t m_u32CacheStamp = 0UL;
+#endif
+static stc_w25qxx_cache_stat_t m_stcCacheStat = {0UL, 0UL};
+
+/* Geometry of the attached part, W25Q128 until W25QXX_Configure() read SFDP */
+static stc_w25qxx_geometry_t m_stcW25qxxGeometry = {
+    W25Q128_MAX_ADDR, W25Q128_PAGE_SIZE, W25QXX_CHIP_ERASE_TIMEOUT_MS, 3U,
+    {
+        {W25QXX_SECTOR_ERASE,     W25Q128_SECTOR_SIZE,     W25QXX_SECTOR_ERASE_TIMEOUT_MS},
+        {W25QXX_BLOCK_ERASE_32KB, W25Q128_HALF_BLOCK_SIZE, W25QXX_BLOCK32_ERASE_TIMEOUT_MS},
+        {W25QXX_BLOCK_ERASE_64KB, W25Q128_BLOCK_SIZE,      W25QXX_BLOCK64_ERASE_TIMEOUT_MS},
+        {0U, 0UL, 0UL},
+    },
+};
+
+/* DMA channel setup done ahead of BSP_SPI_DmaRun() */
+static struct {
+    const uint8_t *pu8Tx;
+    uint8_t *pu8Rx;
+    uint32_t u32Count;
+    uint8_t u8Armed;
+} m_stcDmaArm;
+
+/* A program operation was issued and BUSY has not been seen clear yet */
+static uint8_t m_u8W25qxxBusy = 0U;
+
+/* Bytes of the DMA read started by BSP_W25QXX_ReadStart(), 0: none */
+static uint32_t m_u32ReadPending = 0UL;
+
+/* Deep power-down state and the tick of the last device access */
+static uint8_t m_u8W25qxxPd = 0U;
+static uint32_t m_u32W25qxxTick = 0UL;
+/* Address range [u32Addr, u32EndAddr) the running program/erase works on */
+static struct {
+    uint32_t u32Addr;
+    uint32_t u32EndAddr;
+} m_stcBusyRange = {0UL, 0UL};
+
+/* Range erase issued by BSP_W25QXX_EraseRangeAsync() */
+static struct {
+    uint32_t u32Addr;                   /* Next address to be erased */
+    uint32_t u32EndAddr;
+    uint32_t u32Tick;                   /* SysTick when the running command was issued */
+    uint32_t u32TimeoutMs;              /* Maximum time of the running command */
+    int32_t i32Status;
+} m_stcEraseJob = {0UL, 0UL, 0UL, 0UL, LL_OK};
 /**
  * @}
  */
 #define W25QXX_FLAG_BUSY            (1UL << 0U)
 #define W25QXX_FLAG_WEL             (1UL << 1U)         /*!< Write Enable Latch */
-#define W25QXX_FLAG_SUSPEND         (1UL << 15U)        /*!< Write Enable Latch */
+#define W25QXX_FLAG_SUSPEND         (1UL << 15U)        /*!< Erase/Program Suspend, SR2 bit 7 */
 
 #define LOAD_CMD(a, cmd, addr)      do {                                    \
                                         (a)[0U] = (cmd);                    \
@@ -201,6 +293,7 @@ static int32_t W25QXX_Wt(const stc_w25qxx_ll_t *pstcW25qxxLL, \
  * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
  * @param  [in]  u8Cmd                  Command of W25QXX.
  * @param  [in]  u32Addr                The start address of the data to be written.
+ * @param  [in]  u8DummyLen             Dummy bytes between the address and the data.
  * @param  [in]  pu8Data                The data to be stored.
  * @param  [in]  u32DataLen             The length of the data in bytes.
  * @retval int32_t:
@@ -209,10 +302,10 @@ static int32_t W25QXX_Wt(const stc_w25qxx_ll_t *pstcW25qxxLL, \
  *           - LL_ERR_INVD_PARAM:       Invalid parameter.
  */
 static int32_t W25QXX_Rd(const stc_w25qxx_ll_t *pstcW25qxxLL, \
-                         uint8_t u8Cmd, uint32_t u32Addr, \
+                         uint8_t u8Cmd, uint32_t u32Addr, uint8_t u8DummyLen, \
                          uint8_t *pu8Data, uint32_t u32DataLen)
 {
-    uint8_t au8Cmd[4U];
+    uint8_t au8Cmd[4U + W25QXX_FAST_READ_DUMMY];
     int32_t i32Ret = LL_ERR_INVD_PARAM;
 
     if (pstcW25qxxLL == NULL) {
@@ -221,9 +314,13 @@ static int32_t W25QXX_Rd(const stc_w25qxx_ll_t *pstcW25qxxLL, \
 
     if ((pstcW25qxxLL->Active != NULL) && (pstcW25qxxLL->Trans != NULL) && (pstcW25qxxLL->Receive != NULL) &&
         (pstcW25qxxLL->Inactive != NULL)) {
+        if (u8DummyLen > W25QXX_FAST_READ_DUMMY) {
+            return i32Ret;
+        }
         LOAD_CMD(au8Cmd, u8Cmd, u32Addr);
+        (void)memset(&au8Cmd[4U], 0xFF, u8DummyLen);
         pstcW25qxxLL->Active();
-        i32Ret = pstcW25qxxLL->Trans(au8Cmd, 4U);
+        i32Ret = pstcW25qxxLL->Trans(au8Cmd, 4UL + u8DummyLen);
         if (i32Ret == LL_OK) {
             i32Ret = pstcW25qxxLL->Receive(pu8Data, u32DataLen);
         }
@@ -262,19 +359,36 @@ static int32_t W25QXX_WriteDisable(const stc_w25qxx_ll_t *pstcW25qxxLL)
  * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
  * @retval int32_t:
  *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
  *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   Read Status Register-1 is issued once, the device keeps shifting
+ *         SR1 out for as long as CS stays low, so each poll costs one byte.
  */
 static int32_t W25QXX_WaitProcessDone(const stc_w25qxx_ll_t *pstcW25qxxLL)
 {
+    uint8_t u8Cmd = W25QXX_READ_STATUS_REGISTER_1;
     uint8_t u8Status;
-    int32_t i32Ret = LL_ERR_TIMEOUT;
-    volatile uint32_t u32Timecount = W25QXX_TIMEOUT;
+    int32_t i32Ret = LL_ERR_INVD_PARAM;
+    uint32_t u32Timecount = W25QXX_TIMEOUT;
 
-    while (u32Timecount-- != 0UL) {
-        i32Ret = W25QXX_ReadStatus(pstcW25qxxLL, W25QXX_READ_STATUS_REGISTER_1, &u8Status);
-        if ((i32Ret == LL_OK) && ((u8Status & W25QXX_FLAG_BUSY) == 0U)) {
-            break;
+    if (pstcW25qxxLL == NULL) {
+        return i32Ret;
+    }
+
+    if ((pstcW25qxxLL->Active != NULL) && (pstcW25qxxLL->Trans != NULL) && (pstcW25qxxLL->Receive != NULL) &&
+        (pstcW25qxxLL->Inactive != NULL)) {
+        pstcW25qxxLL->Active();
+        i32Ret = pstcW25qxxLL->Trans(&u8Cmd, 1U);
+        while (i32Ret == LL_OK) {
+            i32Ret = pstcW25qxxLL->Receive(&u8Status, 1U);
+            if ((i32Ret == LL_OK) && ((u8Status & W25QXX_FLAG_BUSY) == 0U)) {
+                break;
+            }
+            if (u32Timecount-- == 0UL) {
+                i32Ret = LL_ERR_TIMEOUT;
+            }
         }
+        pstcW25qxxLL->Inactive();
     }
 
     return i32Ret;
@@ -437,8 +551,12 @@ int32_t W25QXX_PowerDown(const stc_w25qxx_ll_t *pstcW25qxxLL)
 
     if ((pstcW25qxxLL != NULL) && (pstcW25qxxLL->Delay != NULL)) {
         i32Ret = W25QXX_WriteCmd(pstcW25qxxLL, W25QXX_POWER_DOWN, NULL, 0U);
-        if (i32Ret == LL_OK) {
+        if ((i32Ret == LL_OK) && (pstcW25qxxLL->DelayUs != NULL)) {
+            pstcW25qxxLL->DelayUs(W25QXX_TDP_US);
+        } else if (i32Ret == LL_OK) {
             pstcW25qxxLL->Delay(1U);
+        } else {
+            /* rsvd */
         }
     }
 
@@ -459,8 +577,12 @@ int32_t W25QXX_ReleasePowerDown(const stc_w25qxx_ll_t *pstcW25qxxLL)
 
     if ((pstcW25qxxLL != NULL) && (pstcW25qxxLL->Delay != NULL)) {
         i32Ret = W25QXX_WriteCmd(pstcW25qxxLL, W25QXX_RELEASE_POWER_DOWN_ID, NULL, 0U);
-        if (i32Ret == LL_OK) {
+        if ((i32Ret == LL_OK) && (pstcW25qxxLL->DelayUs != NULL)) {
+            pstcW25qxxLL->DelayUs(W25QXX_TRES1_US);
+        } else if (i32Ret == LL_OK) {
             pstcW25qxxLL->Delay(1U);
+        } else {
+            /* rsvd */
         }
     }
 
@@ -477,6 +599,8 @@ int32_t W25QXX_ReleasePowerDown(const stc_w25qxx_ll_t *pstcW25qxxLL)
  */
 int32_t W25QXX_EraseChip(const stc_w25qxx_ll_t *pstcW25qxxLL)
 {
+    uint8_t u8Status;
+    uint32_t u32Ms = 0UL;
     int32_t i32Ret = LL_ERR_INVD_PARAM;
 
     if (pstcW25qxxLL != NULL) {
@@ -487,7 +611,19 @@ int32_t W25QXX_EraseChip(const stc_w25qxx_ll_t *pstcW25qxxLL)
         if (i32Ret == LL_OK) {
             i32Ret = W25QXX_WriteCmd(pstcW25qxxLL, W25QXX_CHIP_ERASE, NULL, 0U);
         }
-        if (i32Ret == LL_OK) {
+        /* tCE is far beyond W25QXX_TIMEOUT polls, wait in 1ms steps */
+        while ((i32Ret == LL_OK) && (pstcW25qxxLL->Delay != NULL)) {
+            i32Ret = W25QXX_ReadStatus(pstcW25qxxLL, W25QXX_READ_STATUS_REGISTER_1, &u8Status);
+            if ((i32Ret != LL_OK) || ((u8Status & W25QXX_FLAG_BUSY) == 0U)) {
+                break;
+            }
+            if (u32Ms++ >= m_stcW25qxxGeometry.u32ChipEraseMs) {
+                i32Ret = LL_ERR_TIMEOUT;
+            } else {
+                pstcW25qxxLL->Delay(1U);
+            }
+        }
+        if ((i32Ret == LL_OK) && (pstcW25qxxLL->Delay == NULL)) {
             i32Ret = W25QXX_WaitProcessDone(pstcW25qxxLL);
         }
     }
@@ -537,6 +673,9 @@ int32_t W25QXX_EraseSector(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr
  *           - LL_OK:                   No error occurred.
  *           - LL_ERR_INVD_PARAM:       Invalid parameter.
  *           - LL_ERR_TIMEOUT:          SPI timeout.
+ * @note   Fast Read (0x0B) is used when the transport clock is above
+ *         W25QXX_READ_DATA_SCK_MAX. The whole range is read by one command,
+ *         the address wraps around at the end of the array.
  */
 int32_t W25QXX_ReadData(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr, \
                         uint8_t *pu8ReadBuf, uint32_t u32NumByteToRead)
@@ -544,7 +683,48 @@ int32_t W25QXX_ReadData(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr, \
     int32_t i32Ret = LL_ERR_INVD_PARAM;
 
     if ((pstcW25qxxLL != NULL) && (pu8ReadBuf != NULL) && (u32NumByteToRead != 0UL)) {
-        i32Ret = W25QXX_Rd(pstcW25qxxLL, W25QXX_READ_DATA, u32Addr, pu8ReadBuf, u32NumByteToRead);
+        if ((pstcW25qxxLL->GetSckFreq != NULL) && (pstcW25qxxLL->GetSckFreq() > W25QXX_READ_DATA_SCK_MAX)) {
+            i32Ret = W25QXX_Rd(pstcW25qxxLL, W25QXX_FAST_READ, u32Addr, W25QXX_FAST_READ_DUMMY,
+                               pu8ReadBuf, u32NumByteToRead);
+        } else {
+            i32Ret = W25QXX_Rd(pstcW25qxxLL, W25QXX_READ_DATA, u32Addr, 0U, pu8ReadBuf, u32NumByteToRead);
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Send the read command of W25QXX_ReadData() and keep CS asserted.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @param  [in]  u32Addr                The start address of the data to be read.
+ * @retval int32_t:
+ *           - LL_OK:                   Command sent, CS stays active.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout, CS released.
+ * @note   The caller clocks the data in with its own transfer and ends the
+ *         read with pstcW25qxxLL->Inactive().
+ */
+int32_t W25QXX_ReadBegin(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr)
+{
+    uint8_t au8Cmd[4U + W25QXX_FAST_READ_DUMMY];
+    uint8_t u8DummyLen = 0U;
+    int32_t i32Ret = LL_ERR_INVD_PARAM;
+
+    if ((pstcW25qxxLL != NULL) && (pstcW25qxxLL->Active != NULL) && (pstcW25qxxLL->Trans != NULL) &&
+        (pstcW25qxxLL->Inactive != NULL)) {
+        if ((pstcW25qxxLL->GetSckFreq != NULL) && (pstcW25qxxLL->GetSckFreq() > W25QXX_READ_DATA_SCK_MAX)) {
+            LOAD_CMD(au8Cmd, W25QXX_FAST_READ, u32Addr);
+            u8DummyLen = W25QXX_FAST_READ_DUMMY;
+            (void)memset(&au8Cmd[4U], 0xFF, u8DummyLen);
+        } else {
+            LOAD_CMD(au8Cmd, W25QXX_READ_DATA, u32Addr);
+        }
+        pstcW25qxxLL->Active();
+        i32Ret = pstcW25qxxLL->Trans(au8Cmd, 4UL + u8DummyLen);
+        if (i32Ret != LL_OK) {
+            pstcW25qxxLL->Inactive();
+        }
     }
 
     return i32Ret;
@@ -578,6 +758,333 @@ int32_t W25QXX_PageProgram(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr
 
     return i32Ret;
 }
+
+/**
+ * @brief  W25QXX program an arbitrary range, split at page boundaries.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @param  [in]  u32Addr                Start address, need not be page aligned.
+ * @param  [in]  pu8Data                Pointer to a buffer that contains the data to be written.
+ * @param  [in]  u32NumByteToProgram    Size of the buffer.
+ * @retval int32_t:
+ *           - LL_OK:                   All pages issued.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   The transfer of the next page is armed through Prepare() before
+ *         BUSY of the current page is polled. The function returns while the
+ *         last page is still programming, call W25QXX_WaitIdle() before the
+ *         next access.
+ */
+int32_t W25QXX_Program(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr, \
+                       const uint8_t *pu8Data, uint32_t u32NumByteToProgram)
+{
+    uint32_t u32Size;
+    int32_t i32Ret = LL_ERR_INVD_PARAM;
+
+    if ((pstcW25qxxLL == NULL) || (pu8Data == NULL) || (u32NumByteToProgram == 0UL)) {
+        return i32Ret;
+    }
+
+    while (u32NumByteToProgram != 0UL) {
+        u32Size = m_stcW25qxxGeometry.u32PageSize - (u32Addr % m_stcW25qxxGeometry.u32PageSize);
+        if (u32Size > u32NumByteToProgram) {
+            u32Size = u32NumByteToProgram;
+        }
+
+        if (pstcW25qxxLL->Prepare != NULL) {
+            pstcW25qxxLL->Prepare(pu8Data, u32Size);
+        }
+        /* Previous page */
+        i32Ret = W25QXX_WaitProcessDone(pstcW25qxxLL);
+        if (i32Ret == LL_OK) {
+            i32Ret = W25QXX_WriteEnable(pstcW25qxxLL);
+        }
+        if (i32Ret == LL_OK) {
+            i32Ret = W25QXX_Wt(pstcW25qxxLL, W25QXX_PAGE_PROGRAM, u32Addr, pu8Data, u32Size);
+        }
+        if (i32Ret != LL_OK) {
+            break;
+        }
+        pu8Data = &pu8Data[u32Size];
+        u32Addr += u32Size;
+        u32NumByteToProgram -= u32Size;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Wait until the W25QXX finished the program or erase in progress.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ */
+int32_t W25QXX_WaitIdle(const stc_w25qxx_ll_t *pstcW25qxxLL)
+{
+    return W25QXX_WaitProcessDone(pstcW25qxxLL);
+}
+
+/**
+ * @brief  Issue an erase command without waiting for it to finish.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @param  [in]  u8Cmd                  Erase opcode, one of the erase types of the geometry.
+ * @param  [in]  u32Addr                Any address of the sector or block.
+ * @retval int32_t:
+ *           - LL_OK:                   Erase started.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout.
+ * @note   Poll BUSY with W25QXX_ReadStatus() or wait with W25QXX_WaitIdle().
+ */
+int32_t W25QXX_EraseStart(const stc_w25qxx_ll_t *pstcW25qxxLL, uint8_t u8Cmd, uint32_t u32Addr)
+{
+    uint8_t i;
+    uint8_t u8Valid = 0U;
+    int32_t i32Ret = LL_ERR_INVD_PARAM;
+
+    for (i = 0U; i < m_stcW25qxxGeometry.u8EraseTypeNum; i++) {
+        if (m_stcW25qxxGeometry.astcErase[i].u8Cmd == u8Cmd) {
+            u8Valid = 1U;
+        }
+    }
+    if ((pstcW25qxxLL != NULL) && (u8Valid != 0U)) {
+        i32Ret = W25QXX_WriteEnable(pstcW25qxxLL);
+        if (i32Ret == LL_OK) {
+            i32Ret = W25QXX_Wt(pstcW25qxxLL, u8Cmd, u32Addr, NULL, 0U);
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Suspend the sector/block erase or page program in progress.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @retval int32_t:
+ *           - LL_OK:                   Suspended, only reads outside the
+ *                                      affected page/sector/block are allowed.
+ *           - LL_ERR_NOT_RDY:          Nothing to suspend, the device is idle.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   Chip erase and status register writes can not be suspended, the
+ *         device ignores the command and LL_ERR_TIMEOUT is returned.
+ */
+int32_t W25QXX_Suspend(const stc_w25qxx_ll_t *pstcW25qxxLL)
+{
+    uint8_t u8Status;
+    uint32_t u32Timecount = W25QXX_SUSPEND_TIMEOUT;
+    int32_t i32Ret = W25QXX_ReadStatus(pstcW25qxxLL, W25QXX_READ_STATUS_REGISTER_1, &u8Status);
+
+    if ((i32Ret == LL_OK) && ((u8Status & W25QXX_FLAG_BUSY) == 0U)) {
+        return LL_ERR_NOT_RDY;
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_WriteCmd(pstcW25qxxLL, W25QXX_ERASE_PROGRAM_SUSPEND, NULL, 0U);
+    }
+    /* BUSY clears within tSUS */
+    while (i32Ret == LL_OK) {
+        i32Ret = W25QXX_ReadStatus(pstcW25qxxLL, W25QXX_READ_STATUS_REGISTER_1, &u8Status);
+        if ((i32Ret == LL_OK) && ((u8Status & W25QXX_FLAG_BUSY) == 0U)) {
+            break;
+        }
+        if (u32Timecount-- == 0UL) {
+            i32Ret = LL_ERR_TIMEOUT;
+        }
+    }
+    /* The operation may have finished before the suspend took effect */
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_ReadStatus(pstcW25qxxLL, W25QXX_READ_STATUS_REGISTER_2, &u8Status);
+        if ((i32Ret == LL_OK) && ((u8Status & (uint8_t)(W25QXX_FLAG_SUSPEND >> 8U)) == 0U)) {
+            i32Ret = LL_ERR_NOT_RDY;
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Resume a suspended erase or program.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout.
+ */
+int32_t W25QXX_Resume(const stc_w25qxx_ll_t *pstcW25qxxLL)
+{
+    return W25QXX_WriteCmd(pstcW25qxxLL, W25QXX_ERASE_PROGRAM_RESUME, NULL, 0U);
+}
+
+/**
+ * @brief  Pick the largest erase type that fits at an address.
+ * @param  [in]  u32Addr                Address to be erased next, aligned to the smallest erase type.
+ * @param  [in]  u32EndAddr             End (exclusive) of the range, aligned the same way.
+ * @retval Pointer to the erase type to be issued.
+ * @note   Walked over a range this gives small erases up to the first large
+ *         block boundary, large blocks in the middle and small ones at the tail.
+ */
+const stc_w25qxx_erase_type_t *W25QXX_ErasePlan(uint32_t u32Addr, uint32_t u32EndAddr)
+{
+    const stc_w25qxx_erase_type_t *pstcErase = &m_stcW25qxxGeometry.astcErase[0U];
+    uint32_t u32Left = u32EndAddr - u32Addr;
+    uint8_t i = m_stcW25qxxGeometry.u8EraseTypeNum;
+
+    while (i-- > 1U) {
+        if (((u32Addr % m_stcW25qxxGeometry.astcErase[i].u32Size) == 0UL) &&
+            (u32Left >= m_stcW25qxxGeometry.astcErase[i].u32Size)) {
+            pstcErase = &m_stcW25qxxGeometry.astcErase[i];
+            break;
+        }
+    }
+
+    return pstcErase;
+}
+
+/**
+ * @brief  Read the JEDEC Basic Flash Parameter Table (JESD216) of the part.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @param  [out] pstcGeometry           Geometry decoded from the table.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR:                  No usable SFDP table.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout.
+ * @note   Parts beyond 16MB are limited to their first 16MB, the driver only
+ *         uses 3-byte addresses. Without the JESD216A timing DWORDs the
+ *         current timeouts and page size are kept.
+ */
+int32_t W25QXX_ReadSfdp(const stc_w25qxx_ll_t *pstcW25qxxLL, stc_w25qxx_geometry_t *pstcGeometry)
+{
+    static const uint32_t au32EraseUnitMs[4U] = {1UL, 16UL, 128UL, 1000UL};
+    static const uint32_t au32ChipUnitMs[4U] = {16UL, 256UL, 4000UL, 64000UL};
+    uint8_t au8Buf[W25QXX_SFDP_BFPT_DWORD_MAX * 4U];
+    uint32_t au32Dw[W25QXX_SFDP_BFPT_DWORD_MAX];
+    stc_w25qxx_erase_type_t stcTmp;
+    uint32_t u32Ptr;
+    uint32_t u32Len;
+    uint32_t u32Field;
+    uint32_t u32Mul;
+    uint32_t i;
+    uint32_t j;
+    int32_t i32Ret;
+
+    if ((pstcW25qxxLL == NULL) || (pstcGeometry == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    /* SFDP header and the first parameter header */
+    i32Ret = W25QXX_Rd(pstcW25qxxLL, W25QXX_READ_SFDP_REGISTER, 0UL, 1U, au8Buf, 16U);
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+    if ((((uint32_t)au8Buf[3U] << 24U) | ((uint32_t)au8Buf[2U] << 16U) | ((uint32_t)au8Buf[1U] << 8U) |
+         au8Buf[0U]) != W25QXX_SFDP_SIGNATURE) {
+        return LL_ERR;
+    }
+    /* ID 0xFF00: JEDEC basic flash parameters */
+    if ((au8Buf[8U] != 0x00U) || (au8Buf[15U] != 0xFFU) || (au8Buf[11U] < W25QXX_SFDP_BFPT_DWORD_MIN)) {
+        return LL_ERR;
+    }
+    u32Len = (au8Buf[11U] > W25QXX_SFDP_BFPT_DWORD_MAX) ? W25QXX_SFDP_BFPT_DWORD_MAX : au8Buf[11U];
+    u32Ptr = ((uint32_t)au8Buf[14U] << 16U) | ((uint32_t)au8Buf[13U] << 8U) | au8Buf[12U];
+    i32Ret = W25QXX_Rd(pstcW25qxxLL, W25QXX_READ_SFDP_REGISTER, u32Ptr, 1U, au8Buf, u32Len * 4UL);
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+    for (i = 0UL; i < W25QXX_SFDP_BFPT_DWORD_MAX; i++) {
+        au32Dw[i] = 0UL;
+        if (i < u32Len) {
+            au32Dw[i] = ((uint32_t)au8Buf[(i * 4UL) + 3UL] << 24U) | ((uint32_t)au8Buf[(i * 4UL) + 2UL] << 16U) |
+                        ((uint32_t)au8Buf[(i * 4UL) + 1UL] << 8U) | au8Buf[i * 4UL];
+        }
+    }
+
+    /* DWORD1[18:17]: 4-byte address only */
+    if (((au32Dw[0U] >> 17U) & 0x3UL) == 0x2UL) {
+        return LL_ERR;
+    }
+    /* DWORD2: density in bits */
+    if ((au32Dw[1U] & 0x80000000UL) == 0UL) {
+        pstcGeometry->u32Size = (au32Dw[1U] >> 3U) + 1UL;
+    } else if (((au32Dw[1U] & 0x7FFFFFFFUL) >= 3UL) && ((au32Dw[1U] & 0x7FFFFFFFUL) < W25Q128_MAX_BIT_EXP)) {
+        pstcGeometry->u32Size = 1UL << ((au32Dw[1U] & 0x7FFFFFFFUL) - 3UL);
+    } else {
+        pstcGeometry->u32Size = W25Q128_MAX_ADDR;
+    }
+    if (pstcGeometry->u32Size > W25Q128_MAX_ADDR) {
+        pstcGeometry->u32Size = W25Q128_MAX_ADDR;
+    }
+
+    /* DWORD8/9: erase types, size 2^N bytes and opcode */
+    pstcGeometry->u8EraseTypeNum = 0U;
+    for (i = 0UL; i < 4UL; i++) {
+        u32Field = (au32Dw[7UL + (i / 2UL)] >> ((i % 2UL) * 16UL)) & 0xFFFFUL;
+        if (((u32Field & 0xFFUL) == 0UL) || ((u32Field & 0xFFUL) >= 32UL)) {
+            continue;
+        }
+        stcTmp.u32Size = 1UL << (u32Field & 0xFFUL);
+        stcTmp.u8Cmd = (uint8_t)(u32Field >> 8U);
+        stcTmp.u32TimeoutMs = W25QXX_BLOCK64_ERASE_TIMEOUT_MS;
+        /* DWORD10: typical time (count + 1) * unit, max = typical * 2 * (multiplier + 1) */
+        if (u32Len > 9UL) {
+            u32Mul = 2UL * ((au32Dw[9U] & 0xFUL) + 1UL);
+            u32Field = (au32Dw[9U] >> (4UL + (i * 7UL))) & 0x7FUL;
+            stcTmp.u32TimeoutMs = ((u32Field & 0x1FUL) + 1UL) * au32EraseUnitMs[u32Field >> 5U] * u32Mul;
+        }
+        /* Keep ascending size order */
+        j = pstcGeometry->u8EraseTypeNum;
+        while ((j > 0UL) && (pstcGeometry->astcErase[j - 1UL].u32Size > stcTmp.u32Size)) {
+            pstcGeometry->astcErase[j] = pstcGeometry->astcErase[j - 1UL];
+            j--;
+        }
+        pstcGeometry->astcErase[j] = stcTmp;
+        pstcGeometry->u8EraseTypeNum++;
+    }
+    if (pstcGeometry->u8EraseTypeNum == 0U) {
+        return LL_ERR;
+    }
+
+    /* DWORD11: page size and chip erase time */
+    if (u32Len > 10UL) {
+        pstcGeometry->u32PageSize = 1UL << ((au32Dw[10U] >> 4U) & 0xFUL);
+        u32Mul = 2UL * ((au32Dw[10U] & 0xFUL) + 1UL);
+        u32Field = (au32Dw[10U] >> 24U) & 0x7FUL;
+        pstcGeometry->u32ChipEraseMs = ((u32Field & 0x1FUL) + 1UL) * au32ChipUnitMs[u32Field >> 5U] * u32Mul;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Configure the driver for the attached part from its SFDP table.
+ * @param  [in]  pstcW25qxxLL           Pointer to a @ref stc_w25qxx_ll_t structure.
+ * @retval int32_t:
+ *           - LL_OK:                   Geometry taken from SFDP.
+ *           - LL_ERR:                  No usable SFDP, W25Q128 geometry kept.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout.
+ */
+int32_t W25QXX_Configure(const stc_w25qxx_ll_t *pstcW25qxxLL)
+{
+    stc_w25qxx_geometry_t stcGeometry = m_stcW25qxxGeometry;
+    int32_t i32Ret = W25QXX_ReadSfdp(pstcW25qxxLL, &stcGeometry);
+
+    if (i32Ret == LL_OK) {
+        m_stcW25qxxGeometry = stcGeometry;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Get the geometry the driver works with.
+ * @param  None
+ * @retval Pointer to the geometry.
+ */
+const stc_w25qxx_geometry_t *W25QXX_GetGeometry(void)
+{
+    return &m_stcW25qxxGeometry;
+}
 /*******************************************************************************
  * Function implementation - global ('extern') and local ('static')
  ******************************************************************************/
@@ -607,11 +1114,13 @@ static void BSP_SPI_Inactive(void)
 }
 
 /**
- * @brief  Initializes the BSP SPI interface.
- * @param  None
+ * @brief  Configure the BSP SPI interface.
+ * @param  [in]  u32BaudRate            SPI_BR_CLK_DIVx
+ * @param  [in]  u32IntervalDelay       SPI_INTERVAL_TIME_xSCK between two frames
+ * @param  [in]  u32ReleaseDelay        SPI_RELEASE_TIME_xSCK
  * @retval None
  */
-static void BSP_SPI_Init(void)
+static void BSP_SPI_Config(uint32_t u32BaudRate, uint32_t u32IntervalDelay, uint32_t u32ReleaseDelay)
 {
     stc_gpio_init_t stcGpioInit;
     stc_spi_init_t stcSpiInit;
@@ -646,18 +1155,28 @@ static void BSP_SPI_Init(void)
     stcSpiInit.u32ModeFaultDetect   = SPI_MD_FAULT_DETECT_DISABLE;
     stcSpiInit.u32Parity            = SPI_PARITY_INVD;
     stcSpiInit.u32SpiMode           = SPI_MD_0;
-    stcSpiInit.u32BaudRatePrescaler = SPI_BR_CLK_DIV64;
+    stcSpiInit.u32BaudRatePrescaler = u32BaudRate;
     stcSpiInit.u32DataBits          = SPI_DATA_SIZE_8BIT;
     stcSpiInit.u32FirstBit          = SPI_FIRST_MSB;
     (void)SPI_Init(BSP_SPI_UNIT, &stcSpiInit);
 
-    stcSpiDelayCfg.u32IntervalDelay = SPI_INTERVAL_TIME_8SCK;
-    stcSpiDelayCfg.u32ReleaseDelay  = SPI_RELEASE_TIME_8SCK;
+    stcSpiDelayCfg.u32IntervalDelay = u32IntervalDelay;
+    stcSpiDelayCfg.u32ReleaseDelay  = u32ReleaseDelay;
     stcSpiDelayCfg.u32SetupDelay    = SPI_SETUP_TIME_1SCK;
     (void)SPI_DelayTimeConfig(BSP_SPI_UNIT, &stcSpiDelayCfg);
     SPI_Cmd(BSP_SPI_UNIT, ENABLE);
 }
 
+/**
+ * @brief  Initializes the BSP SPI interface for the polling transport.
+ * @param  None
+ * @retval None
+ */
+static void BSP_SPI_Init(void)
+{
+    BSP_SPI_Config(SPI_BR_CLK_DIV64, SPI_INTERVAL_TIME_8SCK, SPI_RELEASE_TIME_8SCK);
+}
+
 /**
  * @brief  De-Initialize the BSP SPI interface.
  * @param  None
@@ -696,87 +1215,610 @@ static int32_t BSP_SPI_Receive(uint8_t *pu8RxBuf, uint32_t u32Size)
 }
 
 /**
- * @}
+ * @brief  Get the SCK frequency SPI1 is configured for.
+ * @param  None
+ * @retval SCK frequency in Hz
  */
+static uint32_t BSP_SPI_GetSckFreq(void)
+{
+    uint32_t u32Div = READ_REG32_BIT(BSP_SPI_UNIT->CFG2, SPI_CFG2_MBR) >> SPI_CFG2_MBR_POS;
 
-/**
- * @defgroup EV_HC32F460_LQFP100_V2_W25QXX_Global_Functions EV_HC32F460_LQFP100_V2 W25QXX Global Functions
- * @{
- */
+    return CLK_GetBusClockFreq(CLK_BUS_PCLK1) >> (u32Div + 1UL);
+}
 
 /**
- * @brief  Initializes BSP W25QXX.
+ * @brief  Initializes the BSP SPI interface for the DMA transport.
  * @param  None
  * @retval None
+ * @note   No extra SCK between frames, TX and RX are serviced by DMA1 CH1/CH2.
  */
-void BSP_W25QXX_Init(void)
+static void BSP_SPI_DmaInit(void)
 {
-    (void)W25QXX_Init(&m_stcW25qxxLL);
+    BSP_SPI_Config(BSP_SPI_DMA_BR_CLK_DIV, SPI_INTERVAL_TIME_1SCK, SPI_RELEASE_TIME_1SCK);
+
+    BSP_SPI_DMA_FCG_ENABLE();
+    DMA_Cmd(BSP_SPI_DMA_UNIT, ENABLE);
+    AOS_SetTriggerEventSrc(BSP_SPI_DMA_TX_TRIG_SEL, BSP_SPI_DMA_TX_TRIG_EVT_SRC);
+    AOS_SetTriggerEventSrc(BSP_SPI_DMA_RX_TRIG_SEL, BSP_SPI_DMA_RX_TRIG_EVT_SRC);
 }
 
 /**
- * @brief  De-Initializes BSP W25QXX.
+ * @brief  De-Initialize the BSP SPI interface of the DMA transport.
  * @param  None
  * @retval None
+ * @note   DMA1 itself stays enabled, CH0 belongs to the COM port.
  */
-void BSP_W25QXX_DeInit(void)
+static void BSP_SPI_DmaDeInit(void)
 {
-    (void)W25QXX_DeInit(&m_stcW25qxxLL);
+    m_stcDmaArm.u8Armed = 0U;
+    (void)DMA_ChCmd(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_TX_CH, DISABLE);
+    (void)DMA_ChCmd(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_RX_CH, DISABLE);
+    (void)SPI_DeInit(BSP_SPI_UNIT);
 }
 
 /**
- * @brief  Writes an amount of data to W25QXX via SPI interface.
- * @param  [in]  u32Addr                Write start address.
- * @param  [in]  pu8Data                Pointer to data to be written.
- * @param  [in]  u32NumByteToWrite      Size of data to write.
- * @retval int32_t:
- *           - LL_OK:                   No error occurred.
- *           - LL_ERR_INVD_PARAM:       Invalid parameter.
- *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @brief  Load both DMA channels for one run, the channels stay disabled.
+ * @param  [in]  pu8TxBuf               Data to be transmitted, NULL to send 0xFF.
+ * @param  [out] pu8RxBuf               Buffer for the received data, NULL to discard.
+ * @param  [in]  u32Count               Number of data bytes, 1 ~ BSP_SPI_DMA_CNT_MAX.
+ * @retval None
  */
-int32_t BSP_W25QXX_Write(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToWrite)
+static void BSP_SPI_DmaArm(const uint8_t *pu8TxBuf, uint8_t *pu8RxBuf, uint32_t u32Count)
 {
-    uint32_t u32TempSize;
-    uint32_t u32AddrOfst = 0UL;
-    int32_t i32Ret = LL_ERR_INVD_PARAM;
-
-    DDL_ASSERT((u32Addr + u32NumByteToWrite) <= W25Q128_MAX_ADDR);
-
-    if ((pu8Data != NULL) && (u32NumByteToWrite > 0UL)) {
-        while (u32NumByteToWrite != 0UL) {
-            if (u32NumByteToWrite >= W25Q128_PAGE_SIZE) {
-                u32TempSize = W25Q128_PAGE_SIZE;
-            } else {
-                u32TempSize = u32NumByteToWrite;
-            }
-
-            i32Ret = W25QXX_PageProgram(&m_stcW25qxxLL, u32Addr, (const uint8_t *)&pu8Data[u32AddrOfst], u32TempSize);
-            if (i32Ret != LL_OK) {
-                break;
-            }
-            u32NumByteToWrite -= u32TempSize;
-            u32AddrOfst += u32TempSize;
-            u32Addr  += u32TempSize;
-        }
+    static const uint8_t u8TxDummy = 0xFFU;
+    static uint8_t u8RxDummy;
+    stc_dma_init_t stcDmaInit;
+
+    (void)DMA_StructInit(&stcDmaInit);
+    stcDmaInit.u32IntEn      = DMA_INT_DISABLE;
+    stcDmaInit.u32BlockSize  = 1UL;
+    stcDmaInit.u32TransCount = u32Count;
+    stcDmaInit.u32DataWidth  = DMA_DATAWIDTH_8BIT;
+
+    /* TX: buffer -> DR */
+    if (pu8TxBuf != NULL) {
+        stcDmaInit.u32SrcAddr    = (uint32_t)pu8TxBuf;
+        stcDmaInit.u32SrcAddrInc = DMA_SRC_ADDR_INC;
+    } else {
+        stcDmaInit.u32SrcAddr    = (uint32_t)&u8TxDummy;
+        stcDmaInit.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    }
+    stcDmaInit.u32DestAddr    = (uint32_t)&BSP_SPI_UNIT->DR;
+    stcDmaInit.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+    (void)DMA_Init(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_TX_CH, &stcDmaInit);
+
+    /* RX: DR -> buffer */
+    stcDmaInit.u32SrcAddr    = (uint32_t)&BSP_SPI_UNIT->DR;
+    stcDmaInit.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    if (pu8RxBuf != NULL) {
+        stcDmaInit.u32DestAddr    = (uint32_t)pu8RxBuf;
+        stcDmaInit.u32DestAddrInc = DMA_DEST_ADDR_INC;
+    } else {
+        stcDmaInit.u32DestAddr    = (uint32_t)&u8RxDummy;
+        stcDmaInit.u32DestAddrInc = DMA_DEST_ADDR_FIX;
     }
+    (void)DMA_Init(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_RX_CH, &stcDmaInit);
 
-    return i32Ret;
+    m_stcDmaArm.pu8Tx    = pu8TxBuf;
+    m_stcDmaArm.pu8Rx    = pu8RxBuf;
+    m_stcDmaArm.u32Count = u32Count;
+    m_stcDmaArm.u8Armed  = 1U;
 }
 
 /**
- * @brief  Reads an amount of data to W25QXX via SPI interface.
- * @param  [in]  u32Addr                Read start address.
- * @param  [in]  pu8Data                Pointer to data to be read.
+ * @brief  Arm the DMA channels for the next BSP_SPI_DmaTrans() of a buffer.
+ * @param  [in]  pu8TxBuf               The data buffer that to be transmitted.
+ * @param  [in]  u32Size                Number of data bytes to be transmitted.
+ * @retval None
+ * @note   Polled transfers in between do not disturb the disabled channels.
+ */
+static void BSP_SPI_DmaPrepare(const uint8_t *pu8TxBuf, uint32_t u32Size)
+{
+    if ((pu8TxBuf != NULL) && (u32Size >= BSP_SPI_DMA_MIN_LEN) && (u32Size <= BSP_SPI_DMA_CNT_MAX)) {
+        BSP_SPI_DmaArm(pu8TxBuf, NULL, u32Size);
+    }
+}
+
+/**
+ * @brief  Start the armed DMA channels.
+ * @param  None
+ * @retval None
+ * @note   SPI must be disabled and the channels armed by BSP_SPI_DmaArm().
+ */
+static void BSP_SPI_DmaStart(void)
+{
+    DMA_ClearTransCompleteStatus(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_TX_TC_FLAG | BSP_SPI_DMA_RX_TC_FLAG);
+    (void)DMA_ChCmd(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_RX_CH, ENABLE);
+    (void)DMA_ChCmd(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_TX_CH, ENABLE);
+    SPI_Cmd(BSP_SPI_UNIT, ENABLE);
+}
+
+/**
+ * @brief  Wait for the end of a DMA run and stop the channels.
+ * @param  [in]  u32Count               Number of data bytes of the run.
+ * @retval int32_t:
+ *           - LL_OK:                   Transfer successful.
+ *           - LL_ERR_TIMEOUT:          Transfer timeout.
+ */
+static int32_t BSP_SPI_DmaWait(uint32_t u32Count)
+{
+    uint32_t u32Timeout = 0UL;
+    int32_t i32Ret = LL_OK;
+
+    while (SET != DMA_GetTransCompleteStatus(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_RX_TC_FLAG)) {
+        if (u32Timeout++ >= BSP_SPI_DMA_TIMEOUT(u32Count)) {
+            i32Ret = LL_ERR_TIMEOUT;
+            break;
+        }
+    }
+    (void)DMA_ChCmd(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_TX_CH, DISABLE);
+    (void)DMA_ChCmd(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_RX_CH, DISABLE);
+    DMA_ClearTransCompleteStatus(BSP_SPI_DMA_UNIT, BSP_SPI_DMA_TX_TC_FLAG | BSP_SPI_DMA_RX_TC_FLAG);
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Full duplex SPI transfer by DMA.
+ * @param  [in]  pu8TxBuf               Data to be transmitted, NULL to send 0xFF.
+ * @param  [out] pu8RxBuf               Buffer for the received data, NULL to discard.
+ * @param  [in]  u32Size                Number of data bytes.
+ * @retval int32_t:
+ *           - LL_OK:                   Transfer successful.
+ *           - LL_ERR_TIMEOUT:          Transfer timeout.
+ * @note   The RX channel always runs so that the receive buffer never
+ *         overruns, and its completion marks the end of the last frame.
+ */
+static int32_t BSP_SPI_DmaRun(const uint8_t *pu8TxBuf, uint8_t *pu8RxBuf, uint32_t u32Size)
+{
+    uint32_t u32Count;
+    int32_t i32Ret = LL_OK;
+
+    while ((u32Size != 0UL) && (i32Ret == LL_OK)) {
+        u32Count = (u32Size > BSP_SPI_DMA_CNT_MAX) ? BSP_SPI_DMA_CNT_MAX : u32Size;
+
+        /* SPTI is raised when SPI is enabled, so SPI is restarted after DMA is armed */
+        SPI_Cmd(BSP_SPI_UNIT, DISABLE);
+        if ((m_stcDmaArm.u8Armed == 0U) || (m_stcDmaArm.pu8Tx != pu8TxBuf) ||
+            (m_stcDmaArm.pu8Rx != pu8RxBuf) || (m_stcDmaArm.u32Count != u32Count)) {
+            BSP_SPI_DmaArm(pu8TxBuf, pu8RxBuf, u32Count);
+        }
+        m_stcDmaArm.u8Armed = 0U;
+
+        BSP_SPI_DmaStart();
+        i32Ret = BSP_SPI_DmaWait(u32Count);
+
+        if (pu8TxBuf != NULL) {
+            pu8TxBuf = &pu8TxBuf[u32Count];
+        }
+        if (pu8RxBuf != NULL) {
+            pu8RxBuf = &pu8RxBuf[u32Count];
+        }
+        u32Size -= u32Count;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  BSP SPI transmit data by DMA.
+ * @param  [in]  pu8TxBuf               The data buffer that to be transmitted.
+ * @param  [in]  u32Size                Number of data bytes to be transmitted.
+ * @retval int32_t:
+ *           - LL_OK:                   Data transmission successful.
+ *           - LL_ERR_TIMEOUT:          Data transmission timeout.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ */
+static int32_t BSP_SPI_DmaTrans(const uint8_t *pu8TxBuf, uint32_t u32Size)
+{
+    if ((pu8TxBuf == NULL) || (u32Size == 0UL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (u32Size < BSP_SPI_DMA_MIN_LEN) {
+        return BSP_SPI_Trans(pu8TxBuf, u32Size);
+    }
+    return BSP_SPI_DmaRun(pu8TxBuf, NULL, u32Size);
+}
+
+/**
+ * @brief  BSP SPI receive data by DMA.
+ * @param  [in]  pu8RxBuf               The buffer that received data to be stored.
+ * @param  [in]  u32Size                Number of data bytes to be received.
+ * @retval int32_t:
+ *           - LL_OK:                   Data receive successful.
+ *           - LL_ERR_TIMEOUT:          Data receive timeout.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ */
+static int32_t BSP_SPI_DmaReceive(uint8_t *pu8RxBuf, uint32_t u32Size)
+{
+    if ((pu8RxBuf == NULL) || (u32Size == 0UL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (u32Size < BSP_SPI_DMA_MIN_LEN) {
+        return BSP_SPI_Receive(pu8RxBuf, u32Size);
+    }
+    return BSP_SPI_DmaRun(NULL, pu8RxBuf, u32Size);
+}
+
+/**
+ * @brief  Leave deep power-down before a device access.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_TIMEOUT:          SPI timeout.
+ * @note   Finishes a pending BSP_W25QXX_ReadStart() and restarts the idle
+ *         time of BSP_W25QXX_PowerTask().
+ */
+static int32_t BSP_W25QXX_Wake(void)
+{
+    int32_t i32Ret = BSP_W25QXX_ReadWait();
+
+    if ((i32Ret == LL_OK) && (m_u8W25qxxPd != 0U)) {
+        /* Waits tRES1 before the next command */
+        i32Ret = W25QXX_ReleasePowerDown(m_pstcW25qxxLL);
+        if (i32Ret == LL_OK) {
+            m_u8W25qxxPd = 0U;
+        }
+    }
+    m_u32W25qxxTick = SysTick_GetTick();
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Read W25QXX without the cache.
+ * @param  [in]  u32Addr                Read start address.
+ * @param  [in]  pu8Data                Pointer to data to be read.
  * @param  [in]  u32NumByteToRead       Size of data to read.
  * @retval int32_t:
  *           - LL_OK:                   No error occurred.
  *           - LL_ERR_INVD_PARAM:       Invalid parameter.
  *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   A running program or erase that does not cover the read range is
+ *         suspended for the read and resumed afterwards.
+ */
+static int32_t BSP_W25QXX_ReadDirect(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteToRead)
+{
+    uint8_t u8Suspended = 0U;
+    int32_t i32Ret = BSP_W25QXX_Wake();
+
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+    if ((m_u8W25qxxBusy != 0U) &&
+        (((u32Addr + u32NumByteToRead) <= m_stcBusyRange.u32Addr) || (u32Addr >= m_stcBusyRange.u32EndAddr))) {
+        if (W25QXX_Suspend(m_pstcW25qxxLL) == LL_OK) {
+            u8Suspended = 1U;
+        }
+    }
+    if (u8Suspended == 0U) {
+        i32Ret = BSP_W25QXX_WaitIdle();
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_ReadData(m_pstcW25qxxLL, u32Addr, pu8Data, u32NumByteToRead);
+    }
+    if (u8Suspended != 0U) {
+        if (W25QXX_Resume(m_pstcW25qxxLL) != LL_OK) {
+            i32Ret = LL_ERR_TIMEOUT;
+        }
+        /* Time spent suspended does not count against the erase timeout */
+        m_stcEraseJob.u32Tick = SysTick_GetTick();
+    }
+    return i32Ret;
+}
+
+/**
+ * @brief  Drop cached sectors overlapping an address range.
+ * @param  [in]  u32Addr                Start address.
+ * @param  [in]  u32Size                Size in bytes.
+ * @retval None
+ */
+static void BSP_W25QXX_CacheDrop(uint32_t u32Addr, uint32_t u32Size)
+{
+#if (W25QXX_CACHE_SECTOR_NUM > 0U)
+    uint32_t i;
+
+    for (i = 0UL; i < W25QXX_CACHE_SECTOR_NUM; i++) {
+        if ((m_astcCache[i].u32Stamp != 0UL) && (m_astcCache[i].u32Addr < (u32Addr + u32Size)) &&
+            ((m_astcCache[i].u32Addr + W25Q128_SECTOR_SIZE) > u32Addr)) {
+            m_astcCache[i].u32Stamp = 0UL;
+        }
+    }
+#else
+    (void)u32Addr;
+    (void)u32Size;
+#endif
+}
+
+/**
+ * @brief  Apply programmed data to the cached sectors.
+ * @param  [in]  u32Addr                Program start address.
+ * @param  [in]  pu8Data                Programmed data.
+ * @param  [in]  u32Size                Size in bytes.
+ * @retval None
+ * @note   Programming only clears bits, so the cached byte becomes old & new.
+ */
+static void BSP_W25QXX_CacheUpdate(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32Size)
+{
+#if (W25QXX_CACHE_SECTOR_NUM > 0U)
+    uint32_t i;
+    uint32_t u32Start;
+    uint32_t u32End;
+    uint32_t u32Pos;
+
+    for (i = 0UL; i < W25QXX_CACHE_SECTOR_NUM; i++) {
+        if ((m_astcCache[i].u32Stamp == 0UL) || (m_astcCache[i].u32Addr >= (u32Addr + u32Size)) ||
+            ((m_astcCache[i].u32Addr + W25Q128_SECTOR_SIZE) <= u32Addr)) {
+            continue;
+        }
+        u32Start = (u32Addr > m_astcCache[i].u32Addr) ? u32Addr : m_astcCache[i].u32Addr;
+        u32End = u32Addr + u32Size;
+        if (u32End > (m_astcCache[i].u32Addr + W25Q128_SECTOR_SIZE)) {
+            u32End = m_astcCache[i].u32Addr + W25Q128_SECTOR_SIZE;
+        }
+        for (u32Pos = u32Start; u32Pos < u32End; u32Pos++) {
+            m_astcCache[i].au8Data[u32Pos - m_astcCache[i].u32Addr] &= pu8Data[u32Pos - u32Addr];
+        }
+    }
+#else
+    (void)u32Addr;
+    (void)pu8Data;
+    (void)u32Size;
+#endif
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup EV_HC32F460_LQFP100_V2_W25QXX_Global_Functions EV_HC32F460_LQFP100_V2 W25QXX Global Functions
+ * @{
+ */
+
+/**
+ * @brief  Initializes BSP W25QXX.
+ * @param  None
+ * @retval None
+ */
+void BSP_W25QXX_Init(void)
+{
+    (void)W25QXX_Init(m_pstcW25qxxLL);
+    /* The chip keeps deep power-down across an MCU reset */
+    m_u8W25qxxPd = 1U;
+    (void)BSP_W25QXX_Wake();
+    (void)W25QXX_Configure(m_pstcW25qxxLL);
+}
+
+/**
+ * @brief  De-Initializes BSP W25QXX.
+ * @param  None
+ * @retval None
+ */
+void BSP_W25QXX_DeInit(void)
+{
+    (void)BSP_W25QXX_WaitIdle();
+    /* Leave the chip in standby for the application */
+    (void)BSP_W25QXX_Wake();
+    (void)W25QXX_DeInit(m_pstcW25qxxLL);
+}
+
+/**
+ * @brief  Writes an amount of data to W25QXX via SPI interface.
+ * @param  [in]  u32Addr                Write start address.
+ * @param  [in]  pu8Data                Pointer to data to be written.
+ * @param  [in]  u32NumByteToWrite      Size of data to write.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   Returns after the last page is programmed.
+ */
+int32_t BSP_W25QXX_Write(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToWrite)
+{
+    int32_t i32Ret = BSP_W25QXX_WriteBulk(u32Addr, pu8Data, u32NumByteToWrite);
+
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_WaitIdle();
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Writes a large block to W25QXX without waiting for the last page.
+ * @param  [in]  u32Addr                Write start address.
+ * @param  [in]  pu8Data                Pointer to data to be written, must stay
+ *                                      valid until the next BSP_W25QXX_xxx() call.
+ * @param  [in]  u32NumByteToWrite      Size of data to write.
+ * @retval int32_t:
+ *           - LL_OK:                   All pages issued.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   The caller can refill its buffer while the last page programs,
+ *         every other BSP_W25QXX_xxx() call waits for BUSY first.
+ */
+int32_t BSP_W25QXX_WriteBulk(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToWrite)
+{
+    int32_t i32Ret;
+
+    DDL_ASSERT((u32Addr + u32NumByteToWrite) <= m_stcW25qxxGeometry.u32Size);
+
+    i32Ret = BSP_W25QXX_Wake();
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+    i32Ret = W25QXX_Program(m_pstcW25qxxLL, u32Addr, pu8Data, u32NumByteToWrite);
+    m_u8W25qxxBusy = 1U;
+    if (i32Ret == LL_OK) {
+        BSP_W25QXX_CacheUpdate(u32Addr, pu8Data, u32NumByteToWrite);
+    } else {
+        BSP_W25QXX_CacheDrop(u32Addr, u32NumByteToWrite);
+    }
+    /* Only the last page can still be programming */
+    if (u32NumByteToWrite != 0UL) {
+        m_stcBusyRange.u32EndAddr = u32Addr + u32NumByteToWrite;
+        m_stcBusyRange.u32Addr    = (m_stcBusyRange.u32EndAddr - 1UL) & ~(m_stcW25qxxGeometry.u32PageSize - 1UL);
+        if (m_stcBusyRange.u32Addr < u32Addr) {
+            m_stcBusyRange.u32Addr = u32Addr;
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Waits for the end of a program started by BSP_W25QXX_WriteBulk().
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ */
+int32_t BSP_W25QXX_WaitIdle(void)
+{
+    int32_t i32Ret = LL_OK;
+
+    if (m_u8W25qxxBusy != 0U) {
+        i32Ret = W25QXX_WaitIdle(m_pstcW25qxxLL);
+        if (i32Ret == LL_OK) {
+            m_u8W25qxxBusy = 0U;
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Reads an amount of data to W25QXX via SPI interface.
+ * @param  [in]  u32Addr                Read start address.
+ * @param  [in]  pu8Data                Pointer to data to be read.
+ * @param  [in]  u32NumByteToRead       Size of data to read.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   Reads shorter than a sector go through the sector cache, longer
+ *         (streaming) reads bypass it so they do not evict small records.
  */
 int32_t BSP_W25QXX_Read(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteToRead)
 {
-    DDL_ASSERT((u32Addr + u32NumByteToRead) <= W25Q128_MAX_ADDR);
-    return W25QXX_ReadData(&m_stcW25qxxLL, u32Addr, pu8Data, u32NumByteToRead);
+#if (W25QXX_CACHE_SECTOR_NUM > 0U)
+    uint32_t i;
+    uint32_t u32Slot;
+    uint32_t u32Sector;
+    uint32_t u32Ofs;
+    uint32_t u32Len;
+    int32_t i32Ret = LL_OK;
+
+    DDL_ASSERT((u32Addr + u32NumByteToRead) <= m_stcW25qxxGeometry.u32Size);
+    if ((pu8Data == NULL) || (u32NumByteToRead == 0UL) || (u32NumByteToRead >= W25Q128_SECTOR_SIZE)) {
+        return BSP_W25QXX_ReadDirect(u32Addr, pu8Data, u32NumByteToRead);
+    }
+
+    while ((u32NumByteToRead != 0UL) && (i32Ret == LL_OK)) {
+        u32Sector = u32Addr & ~(W25Q128_SECTOR_SIZE - 1UL);
+        u32Ofs = u32Addr - u32Sector;
+        u32Len = W25Q128_SECTOR_SIZE - u32Ofs;
+        if (u32Len > u32NumByteToRead) {
+            u32Len = u32NumByteToRead;
+        }
+
+        /* Hit, or the least recently used slot */
+        u32Slot = 0UL;
+        for (i = 0UL; i < W25QXX_CACHE_SECTOR_NUM; i++) {
+            if ((m_astcCache[i].u32Stamp != 0UL) && (m_astcCache[i].u32Addr == u32Sector)) {
+                u32Slot = i;
+                break;
+            }
+            if (m_astcCache[i].u32Stamp < m_astcCache[u32Slot].u32Stamp) {
+                u32Slot = i;
+            }
+        }
+        if (i < W25QXX_CACHE_SECTOR_NUM) {
+            m_stcCacheStat.u32Hit++;
+        } else {
+            m_stcCacheStat.u32Miss++;
+            m_astcCache[u32Slot].u32Stamp = 0UL;
+            i32Ret = BSP_W25QXX_ReadDirect(u32Sector, m_astcCache[u32Slot].au8Data, W25Q128_SECTOR_SIZE);
+            m_astcCache[u32Slot].u32Addr = u32Sector;
+        }
+        if (i32Ret == LL_OK) {
+            m_astcCache[u32Slot].u32Stamp = ++m_u32CacheStamp;
+            (void)memcpy(pu8Data, &m_astcCache[u32Slot].au8Data[u32Ofs], u32Len);
+            pu8Data = &pu8Data[u32Len];
+            u32Addr += u32Len;
+            u32NumByteToRead -= u32Len;
+        }
+    }
+
+    return i32Ret;
+#else
+    DDL_ASSERT((u32Addr + u32NumByteToRead) <= m_stcW25qxxGeometry.u32Size);
+    return BSP_W25QXX_ReadDirect(u32Addr, pu8Data, u32NumByteToRead);
+#endif
+}
+
+/**
+ * @brief  Start reading a block of W25QXX in the background.
+ * @param  [in]  u32Addr                Read start address.
+ * @param  [in]  pu8Data                Buffer for the data, must stay valid until
+ *                                      BSP_W25QXX_ReadWait() returns.
+ * @param  [in]  u32NumByteToRead       Size of data to read.
+ * @retval int32_t:
+ *           - LL_OK:                   Read started (or already done).
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   With the DMA transport the data is clocked in by DMA while the CPU
+ *         does other work, e.g. programs the previous block into the EFM.
+ *         Otherwise, or for sizes the DMA can not take in one run, the read
+ *         completes before return. The cache is bypassed.
+ */
+int32_t BSP_W25QXX_ReadStart(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteToRead)
+{
+    int32_t i32Ret;
+
+    DDL_ASSERT((u32Addr + u32NumByteToRead) <= m_stcW25qxxGeometry.u32Size);
+    if ((m_pstcW25qxxLL != &m_stcW25qxxDmaLL) || (pu8Data == NULL) ||
+        (u32NumByteToRead < BSP_SPI_DMA_MIN_LEN) || (u32NumByteToRead > BSP_SPI_DMA_CNT_MAX)) {
+        return BSP_W25QXX_ReadDirect(u32Addr, pu8Data, u32NumByteToRead);
+    }
+
+    i32Ret = BSP_W25QXX_Wake();
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_WaitIdle();
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_ReadBegin(m_pstcW25qxxLL, u32Addr);
+    }
+    if (i32Ret == LL_OK) {
+        SPI_Cmd(BSP_SPI_UNIT, DISABLE);
+        BSP_SPI_DmaArm(NULL, pu8Data, u32NumByteToRead);
+        m_stcDmaArm.u8Armed = 0U;
+        BSP_SPI_DmaStart();
+        m_u32ReadPending = u32NumByteToRead;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Wait for the read started by BSP_W25QXX_ReadStart().
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK:                   No read pending or the read is complete.
+ *           - LL_ERR_TIMEOUT:          SPI timeout.
+ */
+int32_t BSP_W25QXX_ReadWait(void)
+{
+    int32_t i32Ret = LL_OK;
+
+    if (m_u32ReadPending != 0UL) {
+        i32Ret = BSP_SPI_DmaWait(m_u32ReadPending);
+        BSP_SPI_Inactive();
+        m_u32ReadPending = 0UL;
+    }
+
+    return i32Ret;
 }
 
 /**
@@ -788,8 +1830,18 @@ int32_t BSP_W25QXX_Read(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteT
  */
 int32_t BSP_W25QXX_EraseSector(uint32_t u32Addr)
 {
-    DDL_ASSERT(u32Addr < W25Q128_MAX_ADDR);
-    return W25QXX_EraseSector(&m_stcW25qxxLL, u32Addr);
+    int32_t i32Ret;
+
+    DDL_ASSERT(u32Addr < m_stcW25qxxGeometry.u32Size);
+    BSP_W25QXX_CacheDrop(u32Addr & ~(W25Q128_SECTOR_SIZE - 1UL), W25Q128_SECTOR_SIZE);
+    i32Ret = BSP_W25QXX_Wake();
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_WaitIdle();
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_EraseSector(m_pstcW25qxxLL, u32Addr);
+    }
+    return i32Ret;
 }
 
 /**
@@ -801,8 +1853,300 @@ int32_t BSP_W25QXX_EraseSector(uint32_t u32Addr)
  */
 int32_t BSP_W25QXX_EraseChip(void)
 {
-    return W25QXX_EraseChip(&m_stcW25qxxLL);
+    int32_t i32Ret;
+
+    BSP_W25QXX_CacheInvalidate();
+    i32Ret = BSP_W25QXX_Wake();
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_WaitIdle();
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_EraseChip(m_pstcW25qxxLL);
+    }
+    return i32Ret;
+}
+
+/**
+ * @brief  Start erasing an address range with the fewest erase commands.
+ * @param  [in]  u32Addr                Start address, rounded down to a sector.
+ * @param  [in]  u32Size                Size in bytes, the end is rounded up to a sector.
+ * @retval int32_t:
+ *           - LL_OK:                   Erase started.
+ *           - LL_ERR_BUSY:             A range erase is still running.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   Call BSP_W25QXX_EraseRangePoll() until it stops returning
+ *         LL_ERR_BUSY, the next command is issued from there. Do not program
+ *         the range before that.
+ */
+int32_t BSP_W25QXX_EraseRangeAsync(uint32_t u32Addr, uint32_t u32Size)
+{
+    uint32_t u32Align = m_stcW25qxxGeometry.astcErase[0U].u32Size;
+    const stc_w25qxx_erase_type_t *pstcErase;
+    int32_t i32Ret;
+
+    if ((u32Size == 0UL) || (u32Addr >= m_stcW25qxxGeometry.u32Size) ||
+        (u32Size > (m_stcW25qxxGeometry.u32Size - u32Addr))) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (m_stcEraseJob.i32Status == LL_ERR_BUSY) {
+        return LL_ERR_BUSY;
+    }
+    i32Ret = BSP_W25QXX_Wake();
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_WaitIdle();
+    }
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+
+    m_stcEraseJob.u32EndAddr = ((u32Addr + u32Size + u32Align - 1UL) / u32Align) * u32Align;
+    m_stcEraseJob.u32Addr    = (u32Addr / u32Align) * u32Align;
+    pstcErase = W25QXX_ErasePlan(m_stcEraseJob.u32Addr, m_stcEraseJob.u32EndAddr);
+    /* Each block leaves the cache when its erase is issued, reads in between may refill the rest */
+    BSP_W25QXX_CacheDrop(m_stcEraseJob.u32Addr, pstcErase->u32Size);
+    i32Ret = W25QXX_EraseStart(m_pstcW25qxxLL, pstcErase->u8Cmd, m_stcEraseJob.u32Addr);
+    if (i32Ret == LL_OK) {
+        m_stcBusyRange.u32Addr    = m_stcEraseJob.u32Addr;
+        m_stcBusyRange.u32EndAddr = m_stcEraseJob.u32Addr + pstcErase->u32Size;
+        m_stcEraseJob.u32Addr  += pstcErase->u32Size;
+        m_stcEraseJob.u32Tick   = SysTick_GetTick();
+        m_stcEraseJob.u32TimeoutMs = pstcErase->u32TimeoutMs;
+        m_stcEraseJob.i32Status = LL_ERR_BUSY;
+        m_u8W25qxxBusy = 1U;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Advance the range erase.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK:                   No range erase running, the last one succeeded.
+ *           - LL_ERR_BUSY:             Erase in progress.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or erase timeout.
+ */
+int32_t BSP_W25QXX_EraseRangePoll(void)
+{
+    uint8_t u8Status;
+    const stc_w25qxx_erase_type_t *pstcErase;
+    int32_t i32Ret;
+
+    if (m_stcEraseJob.i32Status != LL_ERR_BUSY) {
+        return m_stcEraseJob.i32Status;
+    }
+
+    i32Ret = BSP_W25QXX_ReadWait();
+    if (i32Ret == LL_OK) {
+        i32Ret = W25QXX_ReadStatus(m_pstcW25qxxLL, W25QXX_READ_STATUS_REGISTER_1, &u8Status);
+    }
+    if (i32Ret != LL_OK) {
+        m_stcEraseJob.i32Status = i32Ret;
+    } else if ((u8Status & W25QXX_FLAG_BUSY) != 0U) {
+        if ((SysTick_GetTick() - m_stcEraseJob.u32Tick) > m_stcEraseJob.u32TimeoutMs) {
+            m_stcEraseJob.i32Status = LL_ERR_TIMEOUT;
+        }
+    } else {
+        m_u8W25qxxBusy = 0U;
+        if (m_stcEraseJob.u32Addr >= m_stcEraseJob.u32EndAddr) {
+            m_stcEraseJob.i32Status = LL_OK;
+        } else {
+            pstcErase = W25QXX_ErasePlan(m_stcEraseJob.u32Addr, m_stcEraseJob.u32EndAddr);
+            BSP_W25QXX_CacheDrop(m_stcEraseJob.u32Addr, pstcErase->u32Size);
+            i32Ret = W25QXX_EraseStart(m_pstcW25qxxLL, pstcErase->u8Cmd, m_stcEraseJob.u32Addr);
+            if (i32Ret == LL_OK) {
+                m_stcBusyRange.u32Addr    = m_stcEraseJob.u32Addr;
+                m_stcBusyRange.u32EndAddr = m_stcEraseJob.u32Addr + pstcErase->u32Size;
+                m_stcEraseJob.u32Addr += pstcErase->u32Size;
+                m_stcEraseJob.u32Tick  = SysTick_GetTick();
+                m_stcEraseJob.u32TimeoutMs = pstcErase->u32TimeoutMs;
+                m_u8W25qxxBusy = 1U;
+            } else {
+                m_stcEraseJob.i32Status = i32Ret;
+            }
+        }
+    }
+
+    return m_stcEraseJob.i32Status;
+}
+
+/**
+ * @brief  Erase an address range and wait for the end.
+ * @param  [in]  u32Addr                Start address, rounded down to a sector.
+ * @param  [in]  u32Size                Size in bytes, the end is rounded up to a sector.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_BUSY:             A range erase is still running.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or erase timeout.
+ */
+int32_t BSP_W25QXX_EraseRange(uint32_t u32Addr, uint32_t u32Size)
+{
+    int32_t i32Ret = BSP_W25QXX_EraseRangeAsync(u32Addr, u32Size);
+
+    while (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_EraseRangePoll();
+        if (i32Ret != LL_ERR_BUSY) {
+            break;
+        }
+        i32Ret = LL_OK;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Drop all sectors held by the read cache.
+ * @param  None
+ * @retval None
+ */
+void BSP_W25QXX_CacheInvalidate(void)
+{
+#if (W25QXX_CACHE_SECTOR_NUM > 0U)
+    uint32_t i;
+
+    for (i = 0UL; i < W25QXX_CACHE_SECTOR_NUM; i++) {
+        m_astcCache[i].u32Stamp = 0UL;
+    }
+#endif
+}
+
+/**
+ * @brief  Get the read cache hit/miss counters.
+ * @param  [out] pstcStat               Pointer to the counters.
+ * @retval None
+ */
+void BSP_W25QXX_GetCacheStat(stc_w25qxx_cache_stat_t *pstcStat)
+{
+    if (pstcStat != NULL) {
+        *pstcStat = m_stcCacheStat;
+    }
+}
+
+/**
+ * @brief  Select the SPI transport of W25QXX.
+ * @param  [in]  u8Trans                Transport.
+ *   @arg  BSP_W25QXX_TRANS_POLL:       Polled SPI, PCLK1/64 with 8 SCK gaps.
+ *   @arg  BSP_W25QXX_TRANS_DMA:        DMA driven SPI, PCLK1/4 without gaps.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ * @note   SPI1 is re-initialized when the transport changes.
+ */
+int32_t BSP_W25QXX_SetTransport(uint8_t u8Trans)
+{
+    stc_w25qxx_ll_t *pstcNew;
+
+    if (u8Trans == BSP_W25QXX_TRANS_DMA) {
+        pstcNew = &m_stcW25qxxDmaLL;
+    } else if (u8Trans == BSP_W25QXX_TRANS_POLL) {
+        pstcNew = &m_stcW25qxxLL;
+    } else {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (pstcNew != m_pstcW25qxxLL) {
+        (void)BSP_W25QXX_ReadWait();
+        (void)BSP_W25QXX_WaitIdle();
+        (void)W25QXX_DeInit(m_pstcW25qxxLL);
+        m_pstcW25qxxLL = pstcNew;
+        (void)W25QXX_Init(m_pstcW25qxxLL);
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Get the SPI transport of W25QXX.
+ * @param  None
+ * @retval BSP_W25QXX_TRANS_POLL or BSP_W25QXX_TRANS_DMA
+ */
+uint8_t BSP_W25QXX_GetTransport(void)
+{
+    return (m_pstcW25qxxLL == &m_stcW25qxxDmaLL) ? BSP_W25QXX_TRANS_DMA : BSP_W25QXX_TRANS_POLL;
+}
+
+/**
+ * @brief  Put W25QXX into deep power-down once it has been idle for
+ *         W25QXX_PD_IDLE_MS.
+ * @param  None
+ * @retval None
+ * @note   Call from wait loops. The next BSP_W25QXX_xxx() access wakes the
+ *         chip again, reads served by the cache leave it powered down.
+ */
+void BSP_W25QXX_PowerTask(void)
+{
+#if (W25QXX_PD_IDLE_MS > 0UL)
+    if ((m_u8W25qxxPd == 0U) && (m_u8W25qxxBusy == 0U) && (m_u32ReadPending == 0UL) &&
+        (m_stcEraseJob.i32Status != LL_ERR_BUSY) &&
+        ((SysTick_GetTick() - m_u32W25qxxTick) >= W25QXX_PD_IDLE_MS)) {
+        if (W25QXX_PowerDown(m_pstcW25qxxLL) == LL_OK) {
+            m_u8W25qxxPd = 1U;
+        }
+    }
+#endif
+}
+
+#if (W25QXX_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Measure the read and program time of one sector.
+ * @param  [in]  u8Trans                Transport to be measured, see BSP_W25QXX_SetTransport().
+ * @param  [out] pu32ReadUs             Time (us) to read 4KB.
+ * @param  [out] pu32ProgUs             Time (us) to program 4KB.
+ * @retval int32_t:
+ *           - LL_OK:                   No error occurred.
+ *           - LL_ERR:                  Read back data mismatch.
+ *           - LL_ERR_INVD_PARAM:       Invalid parameter.
+ *           - LL_ERR_TIMEOUT:          SPI timeout or W25QXX timeout.
+ * @note   W25QXX_BENCH_ADDR is erased before and after, the transport in use
+ *         is restored on return.
+ */
+int32_t BSP_W25QXX_Benchmark(uint8_t u8Trans, uint32_t *pu32ReadUs, uint32_t *pu32ProgUs)
+{
+    static uint8_t au8Buf[W25Q128_SECTOR_SIZE];
+    uint8_t u8OldTrans = BSP_W25QXX_GetTransport();
+    uint32_t u32Cycle;
+    uint32_t i;
+    int32_t i32Ret;
+
+    if ((pu32ReadUs == NULL) || (pu32ProgUs == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+    i32Ret = BSP_W25QXX_SetTransport(u8Trans);
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+
+    for (i = 0UL; i < W25Q128_SECTOR_SIZE; i++) {
+        au8Buf[i] = (uint8_t)(i * 7UL);
+    }
+    i32Ret = BSP_W25QXX_EraseSector(W25QXX_BENCH_ADDR);
+    if (i32Ret == LL_OK) {
+        u32Cycle = IAP_GetCycleCount();
+        i32Ret = BSP_W25QXX_Write(W25QXX_BENCH_ADDR, au8Buf, W25Q128_SECTOR_SIZE);
+        *pu32ProgUs = IAP_CYCLE_TO_US(IAP_GetCycleCount() - u32Cycle);
+    }
+    if (i32Ret == LL_OK) {
+        (void)memset(au8Buf, 0, W25Q128_SECTOR_SIZE);
+        u32Cycle = IAP_GetCycleCount();
+        i32Ret = BSP_W25QXX_Read(W25QXX_BENCH_ADDR, au8Buf, W25Q128_SECTOR_SIZE);
+        *pu32ReadUs = IAP_CYCLE_TO_US(IAP_GetCycleCount() - u32Cycle);
+    }
+    if (i32Ret == LL_OK) {
+        for (i = 0UL; i < W25Q128_SECTOR_SIZE; i++) {
+            if (au8Buf[i] != (uint8_t)(i * 7UL)) {
+                i32Ret = LL_ERR;
+                break;
+            }
+        }
+    }
+    (void)BSP_W25QXX_EraseSector(W25QXX_BENCH_ADDR);
+    (void)BSP_W25QXX_SetTransport(u8OldTrans);
+
+    return i32Ret;
 }
+#endif /* W25QXX_BENCH_ENABLE */
 
 /******************************************************************************
  * EOF (not truncated)
@@ -22,6 +22,9 @@ extern "C"
 /*******************************************************************************
  * Include files
  ******************************************************************************/
+#include "hc32_ll_aos.h"
+#include "hc32_ll_clk.h"
+#include "hc32_ll_dma.h"
 #include "hc32_ll_fcg.h"
 #include "hc32_ll_gpio.h"
 #include "hc32_ll_spi.h"
@@ -94,6 +97,63 @@ extern "C"
  * @}
  */
 
+/**
+ * @defgroup W25Qxx_SPI_DMA W25Qxx SPI DMA Transport
+ * @{
+ */
+#define BSP_SPI_DMA_UNIT                (CM_DMA1)
+#define BSP_SPI_DMA_FCG_ENABLE()        (FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_DMA1 | FCG0_PERIPH_AOS, ENABLE))
+#define BSP_SPI_DMA_TX_CH               (DMA_CH1)
+#define BSP_SPI_DMA_TX_TRIG_SEL         (AOS_DMA1_1)
+#define BSP_SPI_DMA_TX_TRIG_EVT_SRC     (EVT_SRC_SPI1_SPTI)
+#define BSP_SPI_DMA_TX_TC_FLAG          (DMA_FLAG_TC_CH1)
+#define BSP_SPI_DMA_RX_CH               (DMA_CH2)
+#define BSP_SPI_DMA_RX_TRIG_SEL         (AOS_DMA1_2)
+#define BSP_SPI_DMA_RX_TRIG_EVT_SRC     (EVT_SRC_SPI1_SPRI)
+#define BSP_SPI_DMA_RX_TC_FLAG          (DMA_FLAG_TC_CH2)
+/* Maximum transfer count of one DMA run */
+#define BSP_SPI_DMA_CNT_MAX             (0xFFFFUL)
+/* Shorter transfers (command and address bytes) are cheaper to poll */
+#define BSP_SPI_DMA_MIN_LEN             (16UL)
+/* SCK of the DMA transport: PCLK1(100MHz) / 4 = 25MHz */
+#define BSP_SPI_DMA_BR_CLK_DIV          (SPI_BR_CLK_DIV4)
+/* Polling loops allowed for a DMA run of len bytes */
+#define BSP_SPI_DMA_TIMEOUT(len)        ((uint32_t)BSP_SPI_TIMEOUT + ((len) * 16UL))
+/**
+ * @}
+ */
+
+/**
+ * @defgroup W25Qxx_Transport W25Qxx Transport
+ * @{
+ */
+#define BSP_W25QXX_TRANS_POLL           (0U)    /*!< SPI_Trans/SPI_Receive polling, PCLK1/64 */
+#define BSP_W25QXX_TRANS_DMA            (1U)    /*!< DMA1 CH1/CH2, PCLK1/4 */
+#ifndef BSP_W25QXX_TRANS_DEFAULT
+#define BSP_W25QXX_TRANS_DEFAULT        (BSP_W25QXX_TRANS_DMA)
+#endif
+
+/* 4KB sectors held by the BSP read cache, 0: no cache */
+#ifndef W25QXX_CACHE_SECTOR_NUM
+#define W25QXX_CACHE_SECTOR_NUM         (2U)
+#endif
+
+/* Idle time (ms) before BSP_W25QXX_PowerTask() puts the chip into deep
+   power-down, 0: never */
+#ifndef W25QXX_PD_IDLE_MS
+#define W25QXX_PD_IDLE_MS               (100UL)
+#endif
+
+/* Enable BSP_W25QXX_Benchmark() */
+#ifndef W25QXX_BENCH_ENABLE
+#define W25QXX_BENCH_ENABLE             (DDL_OFF)
+#endif
+/* Scratch sector used by BSP_W25QXX_Benchmark() */
+#define W25QXX_BENCH_ADDR               (W25QXX_GetGeometry()->u32Size - W25Q128_SECTOR_SIZE)
+/**
+ * @}
+ */
+
 /**
  * @defgroup W25Qxx_Size W25Qxx Size
  * @{
@@ -101,8 +161,10 @@ extern "C"
 #define W25Q128_PAGE_SIZE                (256UL)
 #define W25Q128_SECTOR_SIZE              (1024UL * 4UL)
 #define W25Q128_BLOCK_SIZE               (1024UL * 64UL)
+#define W25Q128_HALF_BLOCK_SIZE          (1024UL * 32UL)
 #define W25Q128_PAGE_PER_SECTOR          (W25Q128_SECTOR_SIZE / W25Q128_PAGE_SIZE)
 #define W25Q128_MAX_ADDR                 (0x1000000UL)
+#define W25Q128_MAX_BIT_EXP              (27UL)         /*!< 2^27 bits = 16MB, 3-byte address limit */
 /**
  * @}
  */
@@ -112,14 +174,36 @@ extern "C"
  */
 typedef struct {
   void (*Delay)(uint32_t);
+  void (*DelayUs)(uint32_t);            /*!< Microsecond delay for tDP/tRES1, NULL: Delay(1) */
   void (*Init)(void);
   void (*DeInit)(void);
   void (*Active)(void);
   void (*Inactive)(void);
   int32_t (*Trans)(const uint8_t *, uint32_t);
   int32_t (*Receive)(uint8_t *, uint32_t);
+  uint32_t (*GetSckFreq)(void);         /*!< Current SCK in Hz, NULL: assume a slow clock */
+  void (*Prepare)(const uint8_t *, uint32_t);   /*!< Arm the next Trans() of this buffer, may be NULL */
 } stc_w25qxx_ll_t;
 
+typedef struct {
+  uint8_t u8Cmd;                        /*!< Erase opcode */
+  uint32_t u32Size;                     /*!< Bytes erased by u8Cmd */
+  uint32_t u32TimeoutMs;                /*!< Maximum erase time */
+} stc_w25qxx_erase_type_t;
+
+typedef struct {
+  uint32_t u32Size;                     /*!< Usable array size, at most 16MB (3-byte address) */
+  uint32_t u32PageSize;                 /*!< Program page size */
+  uint32_t u32ChipEraseMs;              /*!< Maximum chip erase time */
+  uint8_t u8EraseTypeNum;
+  stc_w25qxx_erase_type_t astcErase[4]; /*!< Erase types, ascending size */
+} stc_w25qxx_geometry_t;
+
+typedef struct {
+  uint32_t u32Hit;                      /*!< Sectors served from the read cache */
+  uint32_t u32Miss;                     /*!< Sectors loaded from the device */
+} stc_w25qxx_cache_stat_t;
+
 /**
 * @}
 */
@@ -187,11 +271,45 @@ typedef struct {
 * @}
 */
 
+/**
+* @defgroup W25QXX_Read_Mode W25QXX Read Mode
+* @{
+*/
+/* Highest SCK of Read Data (0x03), above it Fast Read (0x0B) is used */
+#define W25QXX_READ_DATA_SCK_MAX                (33000000UL)
+/* Dummy bytes after the address of Fast Read */
+#define W25QXX_FAST_READ_DUMMY                  (1U)
+/**
+* @}
+*/
+
+/**
+* @defgroup W25QXX_SFDP W25QXX SFDP
+* @{
+*/
+#define W25QXX_SFDP_SIGNATURE                   (0x50444653UL)  /*!< "SFDP" */
+#define W25QXX_SFDP_BFPT_DWORD_MIN              (9U)            /*!< JESD216 */
+#define W25QXX_SFDP_BFPT_DWORD_MAX              (11U)           /*!< Up to the timing DWORDs of JESD216A */
+/**
+* @}
+*/
+
 /**
 * @defgroup W25QXX_Timeout_Value W25QXX Timeout Value
 * @{
 */
-#define W25QXX_TIMEOUT                          (100000UL)
+/* Status register polls, sized for tSE(max) at the PCLK1/4 transport */
+#define W25QXX_TIMEOUT                          (1000000UL)
+/* W25Q128JV tSE/tBE1/tBE2/tCE (max), used when the part has no SFDP */
+#define W25QXX_SECTOR_ERASE_TIMEOUT_MS          (400UL)
+#define W25QXX_BLOCK32_ERASE_TIMEOUT_MS         (1600UL)
+#define W25QXX_BLOCK64_ERASE_TIMEOUT_MS         (2000UL)
+#define W25QXX_CHIP_ERASE_TIMEOUT_MS            (200000UL)
+/* tSUS(max) in status polls, SUS is set and BUSY cleared within 20us */
+#define W25QXX_SUSPEND_TIMEOUT                  (1000UL)
+/* tDP/tRES1(max) in us, entering and leaving deep power-down */
+#define W25QXX_TDP_US                           (3UL)
+#define W25QXX_TRES1_US                         (3UL)
 
 #define SYSTEM_PARA_ADDR  0x0000  //系统配置参数保存地址，写以一扇区为单位4096Bytes
 /**
@@ -299,7 +417,17 @@ int32_t W25QXX_ReleasePowerDown(const stc_w25qxx_ll_t *pstcW25qxxLL);
 int32_t W25QXX_EraseChip(const stc_w25qxx_ll_t *pstcW25qxxLL);
 int32_t W25QXX_EraseSector(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr);
 int32_t W25QXX_ReadData(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr, uint8_t *pu8ReadBuf, uint32_t u32NumByteToRead);
+int32_t W25QXX_ReadBegin(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr);
 int32_t W25QXX_PageProgram(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToProgram);
+int32_t W25QXX_Program(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToProgram);
+int32_t W25QXX_WaitIdle(const stc_w25qxx_ll_t *pstcW25qxxLL);
+int32_t W25QXX_EraseStart(const stc_w25qxx_ll_t *pstcW25qxxLL, uint8_t u8Cmd, uint32_t u32Addr);
+const stc_w25qxx_erase_type_t *W25QXX_ErasePlan(uint32_t u32Addr, uint32_t u32EndAddr);
+int32_t W25QXX_ReadSfdp(const stc_w25qxx_ll_t *pstcW25qxxLL, stc_w25qxx_geometry_t *pstcGeometry);
+int32_t W25QXX_Configure(const stc_w25qxx_ll_t *pstcW25qxxLL);
+const stc_w25qxx_geometry_t *W25QXX_GetGeometry(void);
+int32_t W25QXX_Suspend(const stc_w25qxx_ll_t *pstcW25qxxLL);
+int32_t W25QXX_Resume(const stc_w25qxx_ll_t *pstcW25qxxLL);
 /*******************************************************************************
  * Global variable definitions ('extern')
  ******************************************************************************/
@@ -315,9 +443,24 @@ int32_t W25QXX_PageProgram(const stc_w25qxx_ll_t *pstcW25qxxLL, uint32_t u32Addr
 void BSP_W25QXX_Init(void);
 void BSP_W25QXX_DeInit(void);
 int32_t BSP_W25QXX_Write(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToWrite);
+int32_t BSP_W25QXX_WriteBulk(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32NumByteToWrite);
+int32_t BSP_W25QXX_WaitIdle(void);
 int32_t BSP_W25QXX_Read(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteToRead);
+int32_t BSP_W25QXX_ReadStart(uint32_t u32Addr, uint8_t *pu8Data, uint32_t u32NumByteToRead);
+int32_t BSP_W25QXX_ReadWait(void);
 int32_t BSP_W25QXX_EraseSector(uint32_t u32Addr);
 int32_t BSP_W25QXX_EraseChip(void);
+int32_t BSP_W25QXX_EraseRangeAsync(uint32_t u32Addr, uint32_t u32Size);
+int32_t BSP_W25QXX_EraseRangePoll(void);
+int32_t BSP_W25QXX_EraseRange(uint32_t u32Addr, uint32_t u32Size);
+int32_t BSP_W25QXX_SetTransport(uint8_t u8Trans);
+void BSP_W25QXX_CacheInvalidate(void);
+void BSP_W25QXX_GetCacheStat(stc_w25qxx_cache_stat_t *pstcStat);
+uint8_t BSP_W25QXX_GetTransport(void);
+void BSP_W25QXX_PowerTask(void);
+#if (W25QXX_BENCH_ENABLE == DDL_ON)
+int32_t BSP_W25QXX_Benchmark(uint8_t u8Trans, uint32_t *pu32ReadUs, uint32_t *pu32ProgUs);
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,127 @@
+/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\source\Bitmap.c
+ * @brief Pre-rendered UI strings, generated by tools/gen_bitmap.py from Font.c.
+ *        Do not edit.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-05-06       Joe             First version
+ @endverbatim
+
+ */
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+#include "Bitmap.h"
+
+/*******************************************************************************
+ * Global variable definitions (declared in header file with 'extern')
+ ******************************************************************************/
+static const unsigned char m_aucStartingData[213] =
+{
+	0x00,0x40,0x80,0x00,0x00,0xC0,0x40,0x40,0x40,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0xC0,0x80,0x80,0x80,0xC0,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x80,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x80,0x00,0x00,0x00,0xC0,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x04,0xFD,0x80,0x44,0x1B,0x68,0x88,0x68,
+	0x1B,0x04,0x04,0x20,0x24,0x12,0xE9,0xA9,0xA6,0xE4,0xAA,0xA9,0xF0,0x10,0x10,0x00,
+	0xC0,0x3F,0x05,0xE5,0x25,0x25,0x25,0x25,0x25,0xE7,0x00,0x44,0xE4,0x54,0x4C,0x64,
+	0x44,0x82,0x62,0x1F,0x02,0x02,0xFE,0x00,0x3E,0x12,0x12,0x12,0x12,0xFF,0x12,0x12,
+	0x12,0x3F,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x01,0x02,0x02,0x01,0x01,0x00,0x01,0x01,0x02,0x02,0x00,0x00,0x00,0x03,0x02,0x02,
+	0x03,0x02,0x02,0x03,0x00,0x00,0x01,0x00,0x00,0x00,0x03,0x01,0x01,0x01,0x01,0x01,
+	0x03,0x00,0x00,0x00,0x00,0x02,0x02,0x01,0x00,0x00,0x00,0x01,0x02,0x01,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x03,0x00,0x00,0x03,
+	0x03,0x00,0x00,0x03,0x03,
+};
+
+const BitmapSt g_stBitmap_Starting = {0, 3, 71, 3, m_aucStartingData};
+
+static const unsigned char m_aucUpgradeTitleData[180] =
+{
+	0x00,0x40,0x80,0x00,0x00,0xC0,0x40,0x40,0x40,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0xC0,0x80,0x80,0x80,0xC0,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x00,
+	0xC0,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0x80,0x80,0x80,0x80,0x80,0xC0,0x80,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0x00,0x00,0x00,0x00,0x04,0x04,0xFD,0x80,
+	0x44,0x1B,0x68,0x88,0x68,0x1B,0x04,0x04,0x20,0x24,0x12,0xE9,0xA9,0xA6,0xE4,0xAA,
+	0xA9,0xF0,0x10,0x10,0x08,0x09,0x09,0x89,0x7F,0x08,0x08,0x08,0xFF,0x08,0x0C,0x08,
+	0x92,0x9B,0x56,0x53,0x80,0x78,0x0F,0xB0,0x46,0xBD,0x04,0x00,0x00,0x3E,0x12,0x12,
+	0x12,0x12,0xFF,0x12,0x12,0x12,0x3F,0x02,0x00,0x00,0x01,0x02,0x02,0x01,0x01,0x00,
+	0x01,0x01,0x02,0x02,0x00,0x00,0x00,0x03,0x02,0x02,0x03,0x02,0x02,0x03,0x00,0x00,
+	0x02,0x02,0x01,0x00,0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x02,0x01,
+	0x02,0x02,0x01,0x00,0x00,0x00,0x01,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x03,0x00,
+	0x00,0x00,0x00,0x00,
+};
+
+const BitmapSt g_stBitmap_UpgradeTitle = {0, 3, 60, 3, m_aucUpgradeTitleData};
+
+static const unsigned char m_aucUpgradePercentData[60] =
+{
+	0x00,0x80,0x80,0x00,0x00,0x00,0x00,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x0F,0x10,0x90,0x6F,0x18,0xE4,0x13,0x10,0xE0,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x01,0x00,0x00,0x01,0x02,0x02,
+	0x01,0x00,0x03,0x03,0x00,0x00,0x03,0x03,0x00,0x00,0x03,0x03,
+};
+
+const BitmapSt g_stBitmap_UpgradePercent = {81, 3, 20, 3, m_aucUpgradePercentData};
+
+static const unsigned char m_aucUpgradeOkData[216] =
+{
+	0x00,0x40,0x80,0x00,0x00,0xC0,0x40,0x40,0x40,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0xC0,0x80,0x80,0x80,0xC0,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x00,
+	0xC0,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0x80,0x80,0x80,0x80,0x80,0xC0,0x80,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0x40,0x80,0x00,0x00,0x00,0x00,0x00,0x80,
+	0x00,0x00,0x00,0xC0,0x00,0x00,0x00,0x00,0x04,0x04,0xFD,0x80,0x44,0x1B,0x68,0x88,
+	0x68,0x1B,0x04,0x04,0x20,0x24,0x12,0xE9,0xA9,0xA6,0xE4,0xAA,0xA9,0xF0,0x10,0x10,
+	0x08,0x09,0x09,0x89,0x7F,0x08,0x08,0x08,0xFF,0x08,0x0C,0x08,0x92,0x9B,0x56,0x53,
+	0x80,0x78,0x0F,0xB0,0x46,0xBD,0x04,0x00,0x00,0x80,0x7F,0x89,0xF9,0x01,0x0F,0xB1,
+	0xC1,0x3D,0x01,0xC1,0x41,0x41,0x3F,0x21,0x21,0x82,0x42,0x3F,0x02,0x02,0xFF,0x02,
+	0x00,0x00,0x01,0x02,0x02,0x01,0x01,0x00,0x01,0x01,0x02,0x02,0x00,0x00,0x00,0x03,
+	0x02,0x02,0x03,0x02,0x02,0x03,0x00,0x00,0x02,0x02,0x01,0x00,0x00,0x00,0x00,0x00,
+	0x03,0x00,0x00,0x00,0x00,0x00,0x02,0x01,0x02,0x02,0x01,0x00,0x00,0x00,0x01,0x02,
+	0x02,0x01,0x00,0x00,0x02,0x02,0x01,0x00,0x00,0x01,0x02,0x03,0x00,0x00,0x02,0x02,
+	0x01,0x00,0x00,0x00,0x01,0x02,0x01,0x00,
+};
+
+const BitmapSt g_stBitmap_UpgradeOk = {0, 3, 72, 3, m_aucUpgradeOkData};
+
+static const unsigned char m_aucUpgradeFailData[216] =
+{
+	0x00,0x40,0x80,0x00,0x00,0xC0,0x40,0x40,0x40,0xC0,0x00,0x00,0x00,0x00,0x00,0x00,
+	0xC0,0x80,0x80,0x80,0xC0,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x80,0x80,0x00,
+	0xC0,0x00,0x00,0x00,0x00,0x00,0xC0,0x00,0x80,0x80,0x80,0x80,0x80,0xC0,0x80,0x00,
+	0x00,0x00,0x80,0x00,0x00,0xC0,0x00,0x00,0x00,0x80,0x00,0x00,0x00,0x80,0x80,0x80,
+	0x80,0x80,0x00,0xC0,0x00,0x00,0x80,0x00,0x04,0x04,0xFD,0x80,0x44,0x1B,0x68,0x88,
+	0x68,0x1B,0x04,0x04,0x20,0x24,0x12,0xE9,0xA9,0xA6,0xE4,0xAA,0xA9,0xF0,0x10,0x10,
+	0x08,0x09,0x09,0x89,0x7F,0x08,0x08,0x08,0xFF,0x08,0x0C,0x08,0x92,0x9B,0x56,0x53,
+	0x80,0x78,0x0F,0xB0,0x46,0xBD,0x04,0x00,0x08,0x0A,0x09,0x89,0x49,0x3F,0x09,0x49,
+	0x89,0x09,0x0D,0x08,0x00,0x3F,0x80,0x7C,0x80,0x3F,0x04,0x3B,0xC1,0xB9,0x07,0x01,
+	0x00,0x00,0x01,0x02,0x02,0x01,0x01,0x00,0x01,0x01,0x02,0x02,0x00,0x00,0x00,0x03,
+	0x02,0x02,0x03,0x02,0x02,0x03,0x00,0x00,0x02,0x02,0x01,0x00,0x00,0x00,0x00,0x00,
+	0x03,0x00,0x00,0x00,0x00,0x00,0x02,0x01,0x02,0x02,0x01,0x00,0x00,0x00,0x01,0x02,
+	0x02,0x02,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x02,0x02,0x02,0x01,0x00,0x00,
+	0x00,0x02,0x02,0x01,0x00,0x00,0x01,0x02,
+};
+
+const BitmapSt g_stBitmap_UpgradeFail = {0, 3, 72, 3, m_aucUpgradeFailData};
+
+const unsigned short g_ausBitmap_Digit_16x10[10][10] =
+{
+	{0x0000,0x07BC,0x0F1E,0x0C06,0x0C06,0x0C06,0x0C06,0x0F1E,0x07BC,0x0000},	// '0'
+	{0x0000,0x0000,0x0000,0x0008,0x0FBC,0x0FBE,0x0000,0x0000,0x0000,0x0000},	// '1'
+	{0x0000,0x0F82,0x0FC6,0x0CC6,0x0CC6,0x0CC6,0x0CC6,0x0CFE,0x087E,0x0000},	// '2'
+	{0x0000,0x0802,0x0CC6,0x0CC6,0x0CC6,0x0CC6,0x0CC6,0x0FFE,0x0F7E,0x0000},	// '3'
+	{0x0000,0x007E,0x007C,0x0060,0x0060,0x0060,0x0060,0x077C,0x0FBE,0x0000},	// '4'
+	{0x0000,0x083E,0x0C66,0x0C66,0x0C66,0x0C66,0x0C66,0x0FE6,0x0FC2,0x0000},	// '5'
+	{0x0000,0x0FBC,0x0FFE,0x0C66,0x0C66,0x0C66,0x0C66,0x0FE6,0x0FC2,0x0000},	// '6'
+	{0x0000,0x0002,0x0006,0x0006,0x0006,0x0006,0x0006,0x07BE,0x0FBE,0x0000},	// '7'
+	{0x0000,0x07BC,0x0FFE,0x0CE6,0x0CE6,0x0CE6,0x0CE6,0x0FFE,0x07BC,0x0000},	// '8'
+	{0x0000,0x0000,0x083C,0x0C7E,0x0C66,0x0C66,0x0C66,0x0F7E,0x0FBE,0x0000},	// '9'
+};
+
+/******************************************************************************
+ *
+ * EOF (not truncated)
+ *****************************************************************************/
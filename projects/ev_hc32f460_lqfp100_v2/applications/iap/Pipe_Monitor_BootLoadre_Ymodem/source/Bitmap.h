@@ -0,0 +1,67 @@
+/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\source\Bitmap.h
+ * @brief Pre-rendered UI strings, generated by tools/gen_bitmap.py from Font.c.
+ *        Do not edit.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-05-06       Joe             First version
+ @endverbatim
+
+ */
+#ifndef __BITMAP_H__
+#define __BITMAP_H__
+
+/* C binding of definitions if building with C++ compiler */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Global pre-processor symbols/macros ('#define')
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Global type definitions ('typedef')
+ ******************************************************************************/
+//按页对齐的位图, 字符串已按显示位置(含 Y 方向位偏移)渲染
+typedef struct
+{
+	unsigned char ucColumn;		//起始列
+	unsigned char ucPage;		//起始页
+	unsigned char ucWidth;		//列数
+	unsigned char ucPages;		//页数
+	const unsigned char *pucData;	//按页存放, 每页 ucWidth 字节
+} BitmapSt;
+
+/*******************************************************************************
+ * Global variable definitions ('extern')
+ ******************************************************************************/
+extern const BitmapSt g_stBitmap_Starting;	//(0,30) 000F 0010 002B 002C 002D 0532 0532 0532
+extern const BitmapSt g_stBitmap_UpgradeTitle;	//(0,30) 000F 0010 002E 002F 002D
+extern const BitmapSt g_stBitmap_UpgradePercent;	//(80,30) 0528 0532 0532 0532
+extern const BitmapSt g_stBitmap_UpgradeOk;	//(0,30) 000F 0010 002E 002F 0030 0031
+extern const BitmapSt g_stBitmap_UpgradeFail;	//(0,30) 000F 0010 002E 002F 0032 0033
+
+//16x10 字体数字 '0'..'9', 每列14位, 最低位为字符顶行
+extern const unsigned short g_ausBitmap_Digit_16x10[10][10];
+
+/*******************************************************************************
+  Global function prototypes (definition in C source)
+ ******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BITMAP_H__ */
+
+/*******************************************************************************
+ * EOF (not truncated)
+ ******************************************************************************/
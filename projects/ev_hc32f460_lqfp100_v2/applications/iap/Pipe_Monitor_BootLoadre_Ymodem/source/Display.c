@@ -26,10 +26,23 @@
 /*******************************************************************************
  * Local type definitions ('typedef')
  ******************************************************************************/
+//界面状态, 由下载流程等生产者投递, 由 func_UI_Task 渲染
+typedef struct
+{
+	unsigned char ucPhase;		//UI_PHASE_xxx
+	unsigned char ucPercent;	//升级进度 0..100
+	unsigned char ucRssi;		//信号强度 0..31, UI_RSSI_UNKNOWN: 未知
+	unsigned char ucResult;		//升级结果, 0: 成功
+} UI_StateSt;
 
 /*******************************************************************************
  * Local pre-processor symbols/macros ('#define')
  ******************************************************************************/
+//面板状态
+#define UI_PANEL_OFF			(0U)	//未上电
+#define UI_PANEL_ON				(1U)	//正常亮度
+#define UI_PANEL_DIM			(2U)	//低对比度
+#define UI_PANEL_BLANK			(3U)	//关显示, 不再渲染
 
 /*******************************************************************************
  * Global variable definitions (declared in header file with 'extern')
@@ -38,10 +51,17 @@
 /*******************************************************************************
  * Local function prototypes ('static')
  ******************************************************************************/
+static void UI_Panel_Wake(void);
+static void UI_Panel_Idle(void);
 
 /*******************************************************************************
  * Local variable definitions ('static')
  ******************************************************************************/
+static UI_StateSt m_stUIState = {UI_PHASE_STARTING, 0U, UI_RSSI_UNKNOWN, 0U};
+static unsigned char m_ucUIChanged = 0U;	//状态已变化, 等待渲染
+static uint32_t m_u32UILastTick = 0UL;		//上次渲染时刻
+static unsigned char m_ucUIPanel = UI_PANEL_OFF;	//UI_PANEL_xxx
+static uint32_t m_u32UIActiveTick = 0UL;	//上次阶段切换时刻, 用于变暗/关屏计时
 
 void func_sprintf_metricsystem(signed short * buffer, float fb5h,char fb9h,char fbah)
 {
@@ -290,19 +310,10 @@ void func_display_PowerOn_Menu(void)
 //设备启动中...
 void func_Device_Starting_View_Show(unsigned char ucFlag1, unsigned char ucFlag2, unsigned char ucFlag3)
 {
-	signed short sShowArr[10] = {0};
 	clear_screen();
-	sShowArr[0] = 0x000F;
-	sShowArr[1] = 0x0010;
-	sShowArr[2] = 0x002B;
-	sShowArr[3] = 0x002C;
-	sShowArr[4] = 0X002D;
-	sShowArr[5] = 0x0532;
-	sShowArr[6] = 0x0532;
-	sShowArr[7] = 0x0532;
-	sShowArr[8] = 0xFFFF;
-	func_display_string(0,30,&sShowArr[0]);
+	OLED_Draw_Bitmap(&g_stBitmap_Starting);	//"设备启动中..."
 	#if 0
+	signed short sShowArr[10] = {0};
 	sShowArr[0] = (ucFlag1 / 10) | 0x0500; //十位
 	sShowArr[1] = (ucFlag1 % 10) | 0x0500; //个位
 	sShowArr[2] = 0xFFFF;
@@ -322,53 +333,196 @@ void func_Device_Starting_View_Show(unsigned char ucFlag1, unsigned char ucFlag2
 //设备升级中...
 void func_Device_Upgrade_View_Show(void)
 {
-	signed short sShowArr[12] = {0};
-	unsigned short usCnt = 0;
+	unsigned char ucCnt = m_stUIState.ucPercent;
 
-	usCnt = (unsigned short)((float)gul_IAP_Upgrade_Current_Size / (float)gul_IAP_Upgrade_Total_Size * 100.0);
+	if(ucCnt > 99U)	//只有两位数字
+	{
+		ucCnt = 99U;
+	}
 	clear_screen();
-	sShowArr[0] = 0x000F;
-	sShowArr[1] = 0x0010;
-	sShowArr[2] = 0x002E;
-	sShowArr[3] = 0x002F;
-	sShowArr[4] = 0X002D;
-	sShowArr[5] = (usCnt / 10) | 0x0500;
-	sShowArr[6] = (usCnt % 10) | 0x0500;
-	sShowArr[7] = 0x0528;
-	sShowArr[8] = 0x0532;
-	sShowArr[9] = 0x0532;
-	sShowArr[10] = 0x0532;
-	sShowArr[11] = 0xFFFF;
-	func_display_string(0,30,&sShowArr[0]);
+	OLED_Draw_Bitmap(&g_stBitmap_UpgradeTitle);	//"设备升级中"
+	func_display_digit(60, 30, ucCnt / 10U);
+	func_display_digit(70, 30, ucCnt % 10U);
+	OLED_Draw_Bitmap(&g_stBitmap_UpgradePercent);	//"%..."
+	if(m_stUIState.ucRssi != UI_RSSI_UNKNOWN)	//右下角显示信号强度
+	{
+		func_display_digit(108, 48, m_stUIState.ucRssi / 10U);
+		func_display_digit(118, 48, m_stUIState.ucRssi % 10U);
+	}
 	func_Display_128x64();
 }
 
 //设备升级结果
 void func_Device_UpgradeResult_View_Show(unsigned char ucResult)
 {
-	signed short sShowArr[12] = {0};
-	
 	clear_screen();
-	sShowArr[0] = 0x000F;
-	sShowArr[1] = 0x0010;
-	sShowArr[2] = 0x002E;
-	sShowArr[3] = 0x002F;
 	if(ucResult == 0)	//成功
 	{
-		sShowArr[4] = 0x0030;
-		sShowArr[5] = 0x0031;
+		OLED_Draw_Bitmap(&g_stBitmap_UpgradeOk);
 	}
 	else	//失败
 	{
-		sShowArr[4] = 0x0032;
-		sShowArr[5] = 0x0033;
+		OLED_Draw_Bitmap(&g_stBitmap_UpgradeFail);
 	}
-	sShowArr[6] = 0xFFFF;
-	func_display_string(0,30,&sShowArr[0]);
 	func_Display_128x64();
 }
 
 
+//投递界面阶段
+void func_UI_Post_Phase(unsigned char ucPhase)
+{
+	if(m_stUIState.ucPhase != ucPhase)
+	{
+		m_stUIState.ucPhase = ucPhase;
+		m_ucUIChanged = 1U;
+		m_u32UIActiveTick = SysTick_GetTick();
+	}
+}
+
+//投递升级进度, 只在百分比变化时触发重绘
+void func_UI_Post_Progress(unsigned long ulCurrent, unsigned long ulTotal)
+{
+	unsigned char ucPercent;
+
+	if(ulTotal == 0UL)
+	{
+		return;
+	}
+	if(ulCurrent >= ulTotal)
+	{
+		ucPercent = 100U;
+	}
+	else
+	{
+		ucPercent = (unsigned char)(((uint64_t)ulCurrent * 100U) / ulTotal);
+	}
+	if(m_stUIState.ucPercent != ucPercent)
+	{
+		m_stUIState.ucPercent = ucPercent;
+		m_ucUIChanged = 1U;
+	}
+}
+
+//投递信号强度(AT+CSQ 的 rssi)
+void func_UI_Post_Rssi(unsigned char ucRssi)
+{
+	if(ucRssi > 31U)
+	{
+		ucRssi = UI_RSSI_UNKNOWN;
+	}
+	if(m_stUIState.ucRssi != ucRssi)
+	{
+		m_stUIState.ucRssi = ucRssi;
+		m_ucUIChanged = 1U;
+	}
+}
+
+//投递升级结果并切换到结果界面
+void func_UI_Post_Result(unsigned char ucResult)
+{
+	m_stUIState.ucResult = ucResult;
+	m_stUIState.ucPhase = UI_PHASE_RESULT;
+	m_ucUIChanged = 1U;
+	m_u32UIActiveTick = SysTick_GetTick();
+}
+
+//点亮面板: 未上电时上电初始化, 变暗/关屏时恢复
+static void UI_Panel_Wake(void)
+{
+	if(m_ucUIPanel == UI_PANEL_OFF)
+	{
+		func_OLED_PowerUp_Init();
+	}
+	else if(m_ucUIPanel == UI_PANEL_BLANK)
+	{
+		OLED_Display_Switch(1U);
+		OLED_Set_Contrast(UI_CONTRAST_NORMAL);
+	}
+	else if(m_ucUIPanel == UI_PANEL_DIM)
+	{
+		OLED_Set_Contrast(UI_CONTRAST_NORMAL);
+	}
+	m_ucUIPanel = UI_PANEL_ON;
+}
+
+//长时间无阶段切换(如长下载)时逐级变暗、关显示
+static void UI_Panel_Idle(void)
+{
+	uint32_t u32Idle = SysTick_GetTick() - m_u32UIActiveTick;
+
+	if((m_ucUIPanel == UI_PANEL_ON) && (u32Idle >= UI_DIM_MS))
+	{
+		OLED_Set_Contrast(UI_CONTRAST_DIM);
+		m_ucUIPanel = UI_PANEL_DIM;
+	}
+	if((m_ucUIPanel == UI_PANEL_DIM) && (u32Idle >= UI_BLANK_MS))
+	{
+		OLED_Display_Switch(0U);
+		m_ucUIPanel = UI_PANEL_BLANK;
+	}
+}
+
+//关闭面板电源, 跳转APP或复位前调用
+void func_UI_Panel_Off(void)
+{
+	if(m_ucUIPanel != UI_PANEL_OFF)
+	{
+		func_OLED_PowerDown_DeInit();
+		m_ucUIPanel = UI_PANEL_OFF;
+	}
+}
+
+//按当前状态立即渲染
+void func_UI_Flush(void)
+{
+	m_ucUIChanged = 0U;
+	m_u32UILastTick = SysTick_GetTick();
+	if(m_stUIState.ucPhase == UI_PHASE_STARTING)
+	{
+		return;	//启动阶段无需用户关注, 面板保持关闭
+	}
+	if((m_ucUIPanel == UI_PANEL_OFF) || ((SysTick_GetTick() - m_u32UIActiveTick) < UI_DIM_MS))
+	{
+		UI_Panel_Wake();
+	}
+	else if(m_ucUIPanel == UI_PANEL_BLANK)
+	{
+		return;	//已关显示, 只有阶段切换才重新点亮
+	}
+	switch(m_stUIState.ucPhase)
+	{
+	case UI_PHASE_UPGRADE:
+		func_Device_Upgrade_View_Show();
+		break;
+	case UI_PHASE_RESULT:
+		func_Device_UpgradeResult_View_Show(m_stUIState.ucResult);
+		break;
+	default:
+		break;
+	}
+}
+
+/**************************************************
+*void func_UI_Task(void)
+*功能说明：界面服务, 在空闲处(等待模块应答的循环等)调用;
+*          状态变化且距上次渲染不少于 UI_REFRESH_PERIOD_MS 时才重绘,
+*          生产者只投递状态, 不等待显示;
+*          同时按面板策略变暗/关显示
+***************************************************/
+void func_UI_Task(void)
+{
+	UI_Panel_Idle();
+	if(m_ucUIChanged == 0U)
+	{
+		return;
+	}
+	if((SysTick_GetTick() - m_u32UILastTick) < UI_REFRESH_PERIOD_MS)
+	{
+		return;
+	}
+	func_UI_Flush();
+}
+
 //显示授权通过界面
 void func_display_Authorize_Menu(void)
 {
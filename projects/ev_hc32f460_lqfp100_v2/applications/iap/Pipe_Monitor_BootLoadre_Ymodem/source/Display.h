@@ -26,6 +26,30 @@ extern "C"
 /*******************************************************************************
  * Global pre-processor symbols/macros ('#define')
  ******************************************************************************/
+//界面阶段
+#define UI_PHASE_STARTING		(0U)	//设备启动中
+#define UI_PHASE_UPGRADE		(1U)	//升级中, 显示进度及信号强度
+#define UI_PHASE_RESULT			(2U)	//升级结果
+
+#define UI_RSSI_UNKNOWN			(99U)	//AT+CSQ 未知信号强度
+
+//界面最短刷新间隔(ms), 5Hz
+#ifndef UI_REFRESH_PERIOD_MS
+#define UI_REFRESH_PERIOD_MS	(200UL)
+#endif
+
+//面板策略: 启动阶段不点亮, 首个升级/结果界面时才上电;
+//阶段切换后 UI_DIM_MS 无新阶段则降低对比度, UI_BLANK_MS 后关显示
+#ifndef UI_DIM_MS
+#define UI_DIM_MS				(30000UL)
+#endif
+#ifndef UI_BLANK_MS
+#define UI_BLANK_MS				(120000UL)
+#endif
+#define UI_CONTRAST_NORMAL		(0x32U)	//与初始化值一致
+#ifndef UI_CONTRAST_DIM
+#define UI_CONTRAST_DIM			(0x04U)
+#endif
 
 
 /*******************************************************************************
@@ -54,6 +78,14 @@ extern void func_Device_Starting_View_Show(unsigned char ucFlag1, unsigned char
 extern void func_Device_Upgrade_View_Show(void);
 extern void func_Device_UpgradeResult_View_Show(unsigned char ucResult);
 
+extern void func_UI_Post_Phase(unsigned char ucPhase);
+extern void func_UI_Post_Progress(unsigned long ulCurrent, unsigned long ulTotal);
+extern void func_UI_Post_Rssi(unsigned char ucRssi);
+extern void func_UI_Post_Result(unsigned char ucResult);
+extern void func_UI_Task(void);
+extern void func_UI_Flush(void);
+extern void func_UI_Panel_Off(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,6 +19,10 @@
 #include "Font.h"
 #include "string.h"
 #include "hc32_ll_utility.h"
+#include "hc32_ll_spi.h"
+#include "hc32_ll_dma.h"
+#include "hc32_ll_aos.h"
+#include "hc32_ll_fcg.h"
 /*******************************************************************************
  * Local type definitions ('typedef')
  ******************************************************************************/
@@ -26,6 +30,8 @@
 /*******************************************************************************
  * Local pre-processor symbols/macros ('#define')
  ******************************************************************************/
+#define OLED_COLUMN_NUM		(128U)
+#define OLED_PAGE_NUM		(8U)
 
 /*******************************************************************************
  * Global variable definitions (declared in header file with 'extern')
@@ -34,11 +40,23 @@
 /*******************************************************************************
  * Local function prototypes ('static')
  ******************************************************************************/
+static void OLED_Bus_Active(void);
+static void OLED_Bus_Idle(void);
+static void OLED_Write_Page(uint8_t ucPage, uint8_t ucColumn, const uint8_t *pu8Data, uint8_t ucLen);
+#if (OLED_TRANS == OLED_TRANS_SPI_DMA)
+static void OLED_Spi_Init(void);
+static void OLED_Spi_DeInit(void);
+static int32_t OLED_Spi_Send(const uint8_t *pu8Buf, uint32_t u32Len);
+#endif
 
 /*******************************************************************************
  * Local variable definitions ('static')
  ******************************************************************************/
-unsigned char guc_OLED_Buf[128][8] = {0};	//OLED显示数据缓存; 8*8=64行128列
+unsigned char guc_OLED_Buf[8][128] = {0};	//OLED显示数据缓存; 8*8=64行128列, 按页存放与面板写入顺序一致
+static uint8_t m_au8OledShadow[OLED_PAGE_NUM][OLED_COLUMN_NUM];	//面板GRAM当前内容
+static uint8_t m_au8DirtyFirst[OLED_PAGE_NUM];	//每页待刷新的起始列, 大于结束列表示该页无变化
+static uint8_t m_au8DirtyLast[OLED_PAGE_NUM];	//每页待刷新的结束列
+static uint8_t m_u8OledShadowValid = 0U;	//0: 面板内容未知, 脏区不做比较全部发送
 //SystemPataSt *pst_OLEDSystemPara;
 /*******************************************************************************
  * Function implementation - global ('extern') and local ('static')
@@ -224,6 +242,11 @@ void OLED_Write_CMD(uint8_t ucmd)
 	drv_OLED_IIC_Sendbyte(0x00);
 	drv_OLED_IIC_Sendbyte(ucmd);
 	drv_OLED_IIC_Stop();
+	#elif (OLED_TRANS == OLED_TRANS_SPI_DMA)
+	LCMCS_PIN_RESET;
+	LCMRS_PIN_RESET;
+	(void)OLED_Spi_Send(&ucmd, 1UL);
+	LCMCS_PIN_SET;
 	#else
 	uint8_t i;
 
@@ -258,6 +281,11 @@ void OLED_Write_Data(uint8_t uData)
 	drv_OLED_IIC_Sendbyte(0x40);
 	drv_OLED_IIC_Sendbyte(uData);
 	drv_OLED_IIC_Stop();
+	#elif (OLED_TRANS == OLED_TRANS_SPI_DMA)
+	LCMCS_PIN_RESET;
+	LCMRS_PIN_SET;
+	(void)OLED_Spi_Send(&uData, 1UL);
+	LCMCS_PIN_SET;
 	#else
 	uint8_t i;
 	LCMCS_PIN_RESET;
@@ -299,11 +327,17 @@ uint8_t drv_OLED_Init(void)
 
 	GPIO_Init(LCMCS_PORT, LCMCS_PIN, &stcPortInit);
 
+#if (OLED_TRANS == OLED_TRANS_SPI_DMA)
+	OLED_Spi_Init();
+#else
 	drv_mcu_OLED_IIC_Init();
+#endif
 
 	//pst_OLEDSystemPara = GetSystemPara();
 
 	memset(guc_OLED_Buf, 0, sizeof(guc_OLED_Buf));
+	m_u8OledShadowValid = 0U;
+	OLED_Mark_Dirty(0U, 0U, OLED_COLUMN_NUM, OLED_PAGE_NUM);
 
 	//开启OLED电源
 	PWRLCM_PIN_CLOSE();
@@ -354,8 +388,16 @@ void func_OLED_PowerUp_Init(void)
     GPIO_Init(LCMRST_PORT, LCMRST_PIN, &stcPortInit);
 	GPIO_Init(LCMCS_PORT, LCMCS_PIN, &stcPortInit);
 	GPIO_Init(LCMRS_PORT, LCMRS_PIN, &stcPortInit);
+#if (OLED_TRANS == OLED_TRANS_SPI_DMA)
+	OLED_Spi_Init();
+#else
 	GPIO_Init(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, &stcPortInit);
 	GPIO_Init(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, &stcPortInit);
+#endif
+
+	//复位后GRAM内容未知, 下次刷新重发整屏
+	m_u8OledShadowValid = 0U;
+	OLED_Mark_Dirty(0U, 0U, OLED_COLUMN_NUM, OLED_PAGE_NUM);
 
 	//开启OLED电源
 	PWRLCM_PIN_CLOSE();
@@ -401,6 +443,9 @@ void func_OLED_PowerDown_DeInit(void)
     GPIO_StructInit(&stcPortInit);
     stcPortInit.u16PinDir = PIN_DIR_IN;
 	stcPortInit.u16PinAttr = PIN_ATTR_ANALOG;
+#if (OLED_TRANS == OLED_TRANS_SPI_DMA)
+	OLED_Spi_DeInit();
+#endif
 	GPIO_Init(LCMRST_PORT, LCMRST_PIN, &stcPortInit);
 	GPIO_Init(LCMCS_PORT, LCMCS_PIN, &stcPortInit);
 	GPIO_Init(LCMRS_PORT, LCMRS_PIN, &stcPortInit);
@@ -410,6 +455,19 @@ void func_OLED_PowerDown_DeInit(void)
 	PWRLCM_PIN_CLOSE();	//关闭OLED电源
 }
 
+//设置对比度, 0x00~0xff, 上电默认0x32
+void OLED_Set_Contrast(uint8_t ucContrast)
+{
+	OLED_Write_CMD(0x81);
+	OLED_Write_CMD(ucContrast);
+}
+
+//开/关显示, 关显示时面板进入睡眠, GRAM内容保持
+void OLED_Display_Switch(uint8_t ucOn)
+{
+	OLED_Write_CMD((ucOn != 0U) ? 0xAF : 0xAE);
+}
+
 void lcd_address(uint8_t page,uint8_t column) 
 { 
  	column=column-1; //我们平常所说的第 1 列，在 LCD 驱动 IC 里是第 0 列。所以在这里减去1. 
@@ -419,10 +477,10 @@ void lcd_address(uint8_t page,uint8_t column)
  	OLED_Write_CMD(column&0x0f); //设置列地址的低 4 位 
 }
 
-//全屏清屏 
-void clear_screen() 
-{ 
- 	unsigned char i,j; 
+//OLED 串行总线引脚设为输出; SPI 传输时引脚在初始化后保持不变
+static void OLED_Bus_Active(void)
+{
+#if (OLED_TRANS != OLED_TRANS_SPI_DMA)
 	stc_gpio_init_t stcPortInit;
 	GPIO_StructInit(&stcPortInit);
 	stcPortInit.u16PinDir = PIN_DIR_OUT;
@@ -432,72 +490,279 @@ void clear_screen()
 	GPIO_Init(LCMRS_PORT, LCMRS_PIN, &stcPortInit);
 	GPIO_Init(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, &stcPortInit);
 	GPIO_Init(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, &stcPortInit);
- 	for(j=0;j<8;j++) 
- 	{ 
- 		lcd_address(1+j,1); 
- 		for(i=0;i<128;i++) 
- 		{ 
- 			OLED_Write_Data(0x00); 
- 		} 
- 	} 
-	 memset(guc_OLED_Buf, 0, sizeof(guc_OLED_Buf));
-} 
- 
-//显示 128x64 点阵图像 
-void display_128x64(uint8_t *dp) 
-{ 
- 	uint8_t i,j; 
+#endif
+}
+
+//OLED 串行总线引脚设为模拟输入, 降低空闲功耗
+static void OLED_Bus_Idle(void)
+{
+#if (OLED_TRANS != OLED_TRANS_SPI_DMA)
 	stc_gpio_init_t stcPortInit;
 	GPIO_StructInit(&stcPortInit);
 	stcPortInit.u16PinDir = PIN_DIR_IN;
 	stcPortInit.u16PinAttr = PIN_ATTR_ANALOG;
- 	for(j=0;j<8;j++) 
- 	{ 
- 		lcd_address(j+1,1); 
- 		for (i=0;i<128;i++) 
- 		{ 
-			OLED_Write_Data(*dp); //写数据到 LCD,每写完一个 8 位的数据后列地址自动加 1 
- 			dp++; 
- 		} 
- 	} 
 	//PORT_Init(LCMRST_PORT, LCMRST_PIN, &stcPortInit);
 	GPIO_Init(LCMCS_PORT, LCMCS_PIN, &stcPortInit);
 	GPIO_Init(LCMRS_PORT, LCMRS_PIN, &stcPortInit);
 	GPIO_Init(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, &stcPortInit);
 	GPIO_Init(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, &stcPortInit);
+#endif
 }
 
-void func_Display_128x64()
+#if (OLED_TRANS == OLED_TRANS_SPI_DMA)
+/**************************************************
+*static void OLED_Spi_Init(void)
+*功能说明：SCL/SDA 复用为 SPI3 SCK/MOSI, 只发送, 模式3(空闲高电平, 上升沿采样)
+*          与原 GPIO 时序一致; DMA2 CH1 由 SPI3 发送空事件触发
+***************************************************/
+static void OLED_Spi_Init(void)
 {
-	uint8_t i,j; 
 	stc_gpio_init_t stcPortInit;
+	stc_spi_init_t stcSpiInit;
+
 	GPIO_StructInit(&stcPortInit);
-	stcPortInit.u16PinDir = PIN_DIR_IN;
-	stcPortInit.u16PinAttr = PIN_ATTR_ANALOG;
-	for(j=0xb0; j<0xb8; j++)
+	stcPortInit.u16PinDir = PIN_DIR_OUT;
+	stcPortInit.u16PinState = PIN_STAT_SET;
+	GPIO_Init(LCMCS_PORT, LCMCS_PIN, &stcPortInit);
+	GPIO_Init(LCMRS_PORT, LCMRS_PIN, &stcPortInit);
+	GPIO_Init(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, &stcPortInit);
+	GPIO_Init(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, &stcPortInit);
+	GPIO_SetFunc(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, OLED_SPI_SCK_PIN_FUNC);
+	GPIO_SetFunc(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, OLED_SPI_MOSI_PIN_FUNC);
+
+	FCG_Fcg1PeriphClockCmd(OLED_SPI_PERIPH_CLK, ENABLE);
+	(void)SPI_DeInit(OLED_SPI_UNIT);
+	(void)SPI_StructInit(&stcSpiInit);
+	stcSpiInit.u32WireMode          = SPI_3_WIRE;
+	stcSpiInit.u32TransMode         = SPI_SEND_ONLY;
+	stcSpiInit.u32MasterSlave       = SPI_MASTER;
+	stcSpiInit.u32ModeFaultDetect   = SPI_MD_FAULT_DETECT_DISABLE;
+	stcSpiInit.u32Parity            = SPI_PARITY_INVD;
+	stcSpiInit.u32SpiMode           = SPI_MD_3;
+	stcSpiInit.u32BaudRatePrescaler = OLED_SPI_BR_CLK_DIV;
+	stcSpiInit.u32DataBits          = SPI_DATA_SIZE_8BIT;
+	stcSpiInit.u32FirstBit          = SPI_FIRST_MSB;
+	(void)SPI_Init(OLED_SPI_UNIT, &stcSpiInit);
+	SPI_Cmd(OLED_SPI_UNIT, ENABLE);
+
+	OLED_DMA_FCG_ENABLE();
+	DMA_Cmd(OLED_DMA_UNIT, ENABLE);
+	AOS_SetTriggerEventSrc(OLED_DMA_TRIG_SEL, OLED_DMA_TRIG_EVT_SRC);
+}
+
+//关闭 SPI3, 引脚恢复为 GPIO; DMA2 本身保持使能, CH0 用于 Flash 校验
+static void OLED_Spi_DeInit(void)
+{
+	(void)DMA_ChCmd(OLED_DMA_UNIT, OLED_DMA_CH, DISABLE);
+	(void)SPI_DeInit(OLED_SPI_UNIT);
+	GPIO_SetFunc(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, GPIO_FUNC_0);
+	GPIO_SetFunc(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, GPIO_FUNC_0);
+}
+
+/**************************************************
+*static int32_t OLED_Spi_Send(const uint8_t *pu8Buf, uint32_t u32Len)
+*入口参数：pu8Buf: 待发送数据; u32Len: 字节数, 1..0xFFFF
+*出口参数：LL_OK: 发送完成; LL_ERR_TIMEOUT: 发送超时
+*功能说明：短数据轮询发送, 其余一次 DMA 发送; 返回时最后一位已移出,
+*          CS/RS 由调用者控制
+***************************************************/
+static int32_t OLED_Spi_Send(const uint8_t *pu8Buf, uint32_t u32Len)
+{
+	stc_dma_init_t stcDmaInit;
+	uint32_t u32Timeout = 0UL;
+	int32_t i32Ret = LL_OK;
+
+	if(u32Len < OLED_DMA_MIN_LEN)
 	{
-		/*选择LCD的地址*/
-		OLED_Write_CMD(j);
-		OLED_Write_CMD(0x10);
-		OLED_Write_CMD(0x00);
+		return SPI_Trans(OLED_SPI_UNIT, pu8Buf, u32Len, OLED_SPI_TIMEOUT);
+	}
 
-		for(i=0; i<128; i++) 
+	(void)DMA_StructInit(&stcDmaInit);
+	stcDmaInit.u32IntEn       = DMA_INT_DISABLE;
+	stcDmaInit.u32BlockSize   = 1UL;
+	stcDmaInit.u32TransCount  = u32Len;
+	stcDmaInit.u32DataWidth   = DMA_DATAWIDTH_8BIT;
+	stcDmaInit.u32SrcAddr     = (uint32_t)pu8Buf;
+	stcDmaInit.u32SrcAddrInc  = DMA_SRC_ADDR_INC;
+	stcDmaInit.u32DestAddr    = (uint32_t)&OLED_SPI_UNIT->DR;
+	stcDmaInit.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+	(void)DMA_Init(OLED_DMA_UNIT, OLED_DMA_CH, &stcDmaInit);
+
+	//SPI 使能时产生第一个发送空事件, 因此先配置 DMA 再使能 SPI
+	SPI_Cmd(OLED_SPI_UNIT, DISABLE);
+	DMA_ClearTransCompleteStatus(OLED_DMA_UNIT, OLED_DMA_TC_FLAG);
+	(void)DMA_ChCmd(OLED_DMA_UNIT, OLED_DMA_CH, ENABLE);
+	SPI_Cmd(OLED_SPI_UNIT, ENABLE);
+
+	while(SET != DMA_GetTransCompleteStatus(OLED_DMA_UNIT, OLED_DMA_TC_FLAG))
+	{
+		if(u32Timeout++ >= (OLED_SPI_TIMEOUT + u32Len * 32UL))
 		{
-			OLED_Write_Data(guc_OLED_Buf[i][j-0xb0]);
+			i32Ret = LL_ERR_TIMEOUT;
+			break;
 		}
-		
 	}
-	//PORT_Init(LCMRST_PORT, LCMRST_PIN, &stcPortInit);
-	GPIO_Init(LCMCS_PORT, LCMCS_PIN, &stcPortInit);
-	GPIO_Init(LCMRS_PORT, LCMRS_PIN, &stcPortInit);
-	GPIO_Init(OLED_IIC_SDA_PORT, OLED_IIC_SDA_PIN, &stcPortInit);
-	GPIO_Init(OLED_IIC_SCL_PORT, OLED_IIC_SCL_PIN, &stcPortInit);
+	(void)DMA_ChCmd(OLED_DMA_UNIT, OLED_DMA_CH, DISABLE);
+	DMA_ClearTransCompleteStatus(OLED_DMA_UNIT, OLED_DMA_TC_FLAG);
+
+	//等待最后一个字节移出; SPI_FLAG_IDLE 在总线空闲(IDLNF=0)时为 SET
+	u32Timeout = 0UL;
+	while((i32Ret == LL_OK) && (RESET == SPI_GetStatus(OLED_SPI_UNIT, SPI_FLAG_IDLE)))
+	{
+		if(u32Timeout++ >= OLED_SPI_TIMEOUT)
+		{
+			i32Ret = LL_ERR_TIMEOUT;
+		}
+	}
+
+	return i32Ret;
+}
+#endif
+
+/**************************************************
+*static void OLED_Write_Page(uint8_t ucPage, uint8_t ucColumn, const uint8_t *pu8Data, uint8_t ucLen)
+*入口参数：ucPage: 页 0..7; ucColumn: 起始列 0..127; pu8Data: 列数据; ucLen: 列数
+*功能说明：写一页中连续的列; SPI 传输时 CS 全程保持, RS 只在命令/数据边界切换
+***************************************************/
+static void OLED_Write_Page(uint8_t ucPage, uint8_t ucColumn, const uint8_t *pu8Data, uint8_t ucLen)
+{
+#if (OLED_TRANS == OLED_TRANS_SPI_DMA)
+	uint8_t au8Cmd[3];
+
+	au8Cmd[0] = 0xB0U + ucPage;	//页地址
+	au8Cmd[1] = 0x10U | ((ucColumn >> 4) & 0x0FU);	//列地址高4位
+	au8Cmd[2] = ucColumn & 0x0FU;	//列地址低4位
+	LCMCS_PIN_RESET;
+	LCMRS_PIN_RESET;
+	(void)OLED_Spi_Send(au8Cmd, sizeof(au8Cmd));
+	LCMRS_PIN_SET;
+	(void)OLED_Spi_Send(pu8Data, ucLen);
+	LCMCS_PIN_SET;
+#elif (OLED_TRANS == OLED_TRANS_HOST)
+	OLED_Host_Write_Page(ucPage, ucColumn, pu8Data, ucLen);
+#else
+	uint8_t i;
+
+	lcd_address(ucPage + 1U, ucColumn + 1U);
+	for(i=0; i<ucLen; i++)
+	{
+		OLED_Write_Data(pu8Data[i]);
+	}
+#endif
+}
+
+/**************************************************
+*void OLED_Mark_Dirty(uint8_t ucColumn, uint8_t ucPage, uint8_t ucWidth, uint8_t ucPages)
+*入口参数：ucColumn: 起始列 0..127; ucPage: 起始页 0..7
+*          ucWidth: 列数; ucPages: 页数, 超出屏幕部分忽略
+*出口参数：无
+*功能说明：标记 guc_OLED_Buf 中被修改的区域, 由 func_Display_128x64 刷新
+***************************************************/
+void OLED_Mark_Dirty(uint8_t ucColumn, uint8_t ucPage, uint8_t ucWidth, uint8_t ucPages)
+{
+	uint8_t ucLast;
+
+	if((ucWidth == 0U) || (ucColumn >= OLED_COLUMN_NUM))
+	{
+		return;
+	}
+	ucLast = ((uint16_t)ucColumn + ucWidth > OLED_COLUMN_NUM) ? (OLED_COLUMN_NUM - 1U) : (ucColumn + ucWidth - 1U);
+	for(; (ucPages > 0U) && (ucPage < OLED_PAGE_NUM); ucPages--, ucPage++)
+	{
+		if(m_au8DirtyFirst[ucPage] > m_au8DirtyLast[ucPage])
+		{
+			m_au8DirtyFirst[ucPage] = ucColumn;
+			m_au8DirtyLast[ucPage] = ucLast;
+		}
+		else
+		{
+			if(ucColumn < m_au8DirtyFirst[ucPage])
+			{
+				m_au8DirtyFirst[ucPage] = ucColumn;
+			}
+			if(ucLast > m_au8DirtyLast[ucPage])
+			{
+				m_au8DirtyLast[ucPage] = ucLast;
+			}
+		}
+	}
+}
+
+//全屏清屏, 只清缓存, 面板在下次 func_Display_128x64 时按差异更新
+void clear_screen() 
+{ 
+	memset(guc_OLED_Buf, 0, sizeof(guc_OLED_Buf));
+	OLED_Mark_Dirty(0U, 0U, OLED_COLUMN_NUM, OLED_PAGE_NUM);
+} 
+ 
+//显示 128x64 点阵图像, 直接写面板, 不经过 guc_OLED_Buf
+void display_128x64(uint8_t *dp) 
+{ 
+ 	uint8_t j; 
+
+	OLED_Bus_Active();
+ 	for(j=0;j<8;j++) 
+ 	{ 
+		OLED_Write_Page(j, 0U, &dp[j * OLED_COLUMN_NUM], OLED_COLUMN_NUM); //写数据到 LCD,每写完一个 8 位的数据后列地址自动加 1 
+ 	} 
+	memcpy(m_au8OledShadow, dp, sizeof(m_au8OledShadow));
+	OLED_Bus_Idle();
+}
+
+//将 guc_OLED_Buf 刷新到面板: 每页只发送脏区内与面板内容不同的列段
+void func_Display_128x64()
+{
+	uint8_t ucPage, ucFirst, ucLast;
+	uint8_t ucActive = 0U;
+
+	for(ucPage=0; ucPage<OLED_PAGE_NUM; ucPage++)
+	{
+		ucFirst = m_au8DirtyFirst[ucPage];
+		ucLast = m_au8DirtyLast[ucPage];
+		if(ucFirst > ucLast)
+		{
+			continue;
+		}
+		m_au8DirtyFirst[ucPage] = OLED_COLUMN_NUM;
+		m_au8DirtyLast[ucPage] = 0U;
+
+		if(m_u8OledShadowValid != 0U)
+		{
+			while((ucFirst <= ucLast) && (guc_OLED_Buf[ucPage][ucFirst] == m_au8OledShadow[ucPage][ucFirst]))
+			{
+				ucFirst++;
+			}
+			while((ucLast > ucFirst) && (guc_OLED_Buf[ucPage][ucLast] == m_au8OledShadow[ucPage][ucLast]))
+			{
+				ucLast--;
+			}
+			if(ucFirst > ucLast)
+			{
+				continue;
+			}
+		}
+
+		if(ucActive == 0U)
+		{
+			OLED_Bus_Active();
+			ucActive = 1U;
+		}
+		//页内连续, 直接作为 DMA 源
+		OLED_Write_Page(ucPage, ucFirst, &guc_OLED_Buf[ucPage][ucFirst], ucLast - ucFirst + 1U);
+		memcpy(&m_au8OledShadow[ucPage][ucFirst], &guc_OLED_Buf[ucPage][ucFirst], ucLast - ucFirst + 1U);
+	}
+	m_u8OledShadowValid = 1U;
+	if(ucActive != 0U)
+	{
+		OLED_Bus_Idle();
+	}
 }
 
 //显示 32x32 点阵图像、汉字、生僻字或 32x32 点阵的其他图标 
 void display_graphic_32x32(uint8_t page,uint8_t column,uint8_t *dp) 
 { 
 	uint8_t i,j; 
+	m_u8OledShadowValid = 0U;	//绕过缓存直接写面板, 下次刷新不做比较
  	for(j=0;j<4;j++) 
  	{ 
  		lcd_address(page+j,column); 
@@ -513,6 +778,7 @@ void display_graphic_32x32(uint8_t page,uint8_t column,uint8_t *dp)
 void display_graphic_16x16(uint8_t page,uint8_t column,uint8_t *dp) 
 { 
 	uint8_t i,j; 
+	m_u8OledShadowValid = 0U;	//绕过缓存直接写面板, 下次刷新不做比较
  	for(j=0;j<2;j++) 
  	{ 
  		lcd_address(page+j,column); 
@@ -528,6 +794,7 @@ void display_graphic_16x16(uint8_t page,uint8_t column,uint8_t *dp)
 void display_graphic_8x16(uint8_t page,uint8_t column,uint8_t *dp) 
 { 
 	uint8_t i,j; 
+	m_u8OledShadowValid = 0U;	//绕过缓存直接写面板, 下次刷新不做比较
  	for(j=0;j<2;j++) 
  	{ 
  		lcd_address(page+j,column); 
@@ -554,7 +821,7 @@ void OLED_Test(uint8_t ucType)
 		{
 			for(j=0; j<128; j++)
 			{
-				guc_OLED_Buf[j][i] = 0xFF;
+				guc_OLED_Buf[i][j] = 0xFF;
 			}
 		}
 		func_Display_128x64();
@@ -564,7 +831,7 @@ void OLED_Test(uint8_t ucType)
 		{
 			for(j=0; j<128; j++)
 			{
-				guc_OLED_Buf[j][i] = 0xFF;
+				guc_OLED_Buf[i][j] = 0xFF;
 			}
 		}
 		func_Display_128x64();
@@ -574,7 +841,7 @@ void OLED_Test(uint8_t ucType)
 		{
 			for(j=0; j<64; j++)
 			{
-				guc_OLED_Buf[j][i] = 0xFF;
+				guc_OLED_Buf[i][j] = 0xFF;
 			}
 		}
 		func_Display_128x64();
@@ -584,7 +851,7 @@ void OLED_Test(uint8_t ucType)
 		{
 			for(j=64; j<128; j++)
 			{
-				guc_OLED_Buf[j][i] = 0xFF;
+				guc_OLED_Buf[i][j] = 0xFF;
 			}
 		}
 		func_Display_128x64();
@@ -594,7 +861,7 @@ void OLED_Test(uint8_t ucType)
 		{
 			for(j=0; j<128; j++)
 			{
-				guc_OLED_Buf[j][i] = 0xFF;
+				guc_OLED_Buf[i][j] = 0xFF;
 			}
 		}
 		func_Display_128x64();
@@ -622,6 +889,46 @@ void OLED_Test(uint8_t ucType)
 
 
 
+//将预渲染位图拷入显示缓存(覆盖所在区域)
+void OLED_Draw_Bitmap(const BitmapSt *pstBitmap)
+{
+	uint8_t j;
+
+	for(j=0; j<pstBitmap->ucPages; j++)
+	{
+		memcpy(&guc_OLED_Buf[pstBitmap->ucPage + j][pstBitmap->ucColumn],
+		       &pstBitmap->pucData[j * pstBitmap->ucWidth], pstBitmap->ucWidth);
+	}
+	OLED_Mark_Dirty(pstBitmap->ucColumn, pstBitmap->ucPage, pstBitmap->ucWidth, pstBitmap->ucPages);
+}
+
+/**************************************************
+*void func_display_digit(uint8_t X_dot, uint8_t Y_dot, uint8_t ucDigit)
+*入口参数：X_dot:0..117; Y_dot:0..63; ucDigit: 0..9
+*功能说明：以 16x10 字体画一个数字, 与 func_display_string 的 0x050x 相同,
+*          目标区域需为空白(已清屏并只画了位图)
+***************************************************/
+void func_display_digit(uint8_t X_dot, uint8_t Y_dot, uint8_t ucDigit)
+{
+	uint8_t i, ucPage;
+	uint32_t u32Column;
+
+	if(ucDigit > 9U)
+	{
+		return;
+	}
+	for(i=0; i<10U; i++)
+	{
+		u32Column = (uint32_t)g_ausBitmap_Digit_16x10[ucDigit][i] << (Y_dot % 8U);
+		for(ucPage = Y_dot / 8U; (ucPage < OLED_PAGE_NUM) && (u32Column != 0UL); ucPage++)
+		{
+			guc_OLED_Buf[ucPage][X_dot + i] |= (uint8_t)u32Column;
+			u32Column >>= 8;
+		}
+	}
+	OLED_Mark_Dirty(X_dot, Y_dot / 8U, 10U, 3U);
+}
+
 /* -------------------------------------------------------------------------------------------------------------
  *
  *         LCD 坐标原点位于左上角, 纵向向下为Y 8个字节, 横向128列
@@ -639,6 +946,7 @@ void func_display_string(uint8_t X_dot,uint8_t Y_dot,signed short *text)
 	//unsigned char ucX_dot_H, ucX_dot_L;
 	//unsigned short s_xSum = 0;
 	signed char fbm1h,fbm2h,fbm3h;
+	uint8_t ucStartX = X_dot;
 
 	sPosi = 0;
 	while(text[sPosi] != -1)
@@ -663,26 +971,26 @@ void func_display_string(uint8_t X_dot,uint8_t Y_dot,signed short *text)
 				{
 					fbm1h = g_sint8_Font_16x12_12864[sCode][j*2]<<(Y_Bias);
 					
-					guc_OLED_Buf[X_dot][Y_dot/8] |= fbm1h;		
+					guc_OLED_Buf[Y_dot/8][X_dot] |= fbm1h;		
 					
 					fbm1h = ((unsigned char)g_sint8_Font_16x12_12864[sCode][j*2])>>(8-Y_Bias)|(g_sint8_Font_16x12_12864[sCode][j*2+1] << Y_Bias);	
 					
-					guc_OLED_Buf[X_dot][Y_dot/8+1] |= fbm1h;	
+					guc_OLED_Buf[Y_dot/8+1][X_dot] |= fbm1h;	
 					
 				}
 				else
 				{
 					fbm1h = g_sint8_Font_16x12_12864[sCode][j*2] << Y_Bias;
 					
-					guc_OLED_Buf[X_dot][Y_dot/8] |= fbm1h;
+					guc_OLED_Buf[Y_dot/8][X_dot] |= fbm1h;
 					
 					fbm1h = ((unsigned char)g_sint8_Font_16x12_12864[sCode][j*2])>>(8-Y_Bias) | (g_sint8_Font_16x12_12864[sCode][j*2+1]<<Y_Bias);
 					
-					guc_OLED_Buf[X_dot][Y_dot/8+1] |= fbm1h;	
+					guc_OLED_Buf[Y_dot/8+1][X_dot] |= fbm1h;	
 					
 					fbm1h = ((unsigned char)g_sint8_Font_16x12_12864[sCode][j*2+1])>>(8-Y_Bias);
 					
-					guc_OLED_Buf[X_dot][Y_dot/8+2] |= fbm1h;			
+					guc_OLED_Buf[Y_dot/8+2][X_dot] |= fbm1h;			
 					
 				}
 				X_dot++;
@@ -724,36 +1032,36 @@ void func_display_string(uint8_t X_dot,uint8_t Y_dot,signed short *text)
 					fbm19h = 0x00FF;
 					
 				
-					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[X_dot][Y_dot/8];
+					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[Y_dot/8][X_dot];
 						
 					fbm1h |= fbm2h<<Y_Bias;
-					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[X_dot][Y_dot/8];
+					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[Y_dot/8][X_dot];
 						
 					fbm1h |= fbm2h<<Y_Bias;
-					guc_OLED_Buf[X_dot][Y_dot/8] = fbm1h;		
-					fbm1h = (guc_OLED_Buf[X_dot][Y_dot/8+1] & (fbm19h << (13-(8-Y_Bias))));
+					guc_OLED_Buf[Y_dot/8][X_dot] = fbm1h;		
+					fbm1h = (guc_OLED_Buf[Y_dot/8+1][X_dot] & (fbm19h << (13-(8-Y_Bias))));
 				
 					
 					fbm1h |= ( (((unsigned char)fbm2h) >> (8-Y_Bias)) | (fbm3h << Y_Bias));
 				
-					guc_OLED_Buf[X_dot][Y_dot/8 + 1] = fbm1h;		
+					guc_OLED_Buf[Y_dot/8 + 1][X_dot] = fbm1h;		
 				
 				}
 				else
 				{
 					fbm19h = 0x00FF;
 				
-					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[X_dot][Y_dot/8];
+					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[Y_dot/8][X_dot];
 					fbm1h |= fbm2h<<Y_Bias;			
-					guc_OLED_Buf[X_dot][Y_dot/8] = fbm1h;
+					guc_OLED_Buf[Y_dot/8][X_dot] = fbm1h;
 
 					fbm1h = ( (((unsigned char)fbm2h) >> (8-Y_Bias)) | (fbm3h << Y_Bias));	
-					guc_OLED_Buf[X_dot][Y_dot/8 + 1] = fbm1h;			
+					guc_OLED_Buf[Y_dot/8 + 1][X_dot] = fbm1h;			
 
-					fbm1h = guc_OLED_Buf[X_dot][Y_dot/8 + 2] & (fbm19h << (5-(8-Y_Bias)));
+					fbm1h = guc_OLED_Buf[Y_dot/8 + 2][X_dot] & (fbm19h << (5-(8-Y_Bias)));
 							
 					fbm1h |= (((unsigned char)fbm3h) >> (8-Y_Bias));
-					guc_OLED_Buf[X_dot][Y_dot/8 + 2] = fbm1h;	
+					guc_OLED_Buf[Y_dot/8 + 2][X_dot] = fbm1h;	
 				}
 
 				X_dot++;
@@ -791,36 +1099,36 @@ void func_display_string(uint8_t X_dot,uint8_t Y_dot,signed short *text)
 					fbm19h = 0x00FF;
 					
 				
-					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[X_dot][Y_dot/8];
+					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[Y_dot/8][X_dot];
 						
 					fbm1h |= fbm2h<<Y_Bias;
-					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[X_dot][Y_dot/8];
+					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[Y_dot/8][X_dot];
 						
 					fbm1h |= fbm2h<<Y_Bias;
-					guc_OLED_Buf[X_dot][Y_dot/8] = fbm1h;		
-					fbm1h = (guc_OLED_Buf[X_dot][Y_dot/8+1] & (fbm19h << (13-(8-Y_Bias))));
+					guc_OLED_Buf[Y_dot/8][X_dot] = fbm1h;		
+					fbm1h = (guc_OLED_Buf[Y_dot/8+1][X_dot] & (fbm19h << (13-(8-Y_Bias))));
 				
 					
 					fbm1h |= ( (((unsigned char)fbm2h) >> (8-Y_Bias)) | (fbm3h << Y_Bias));
 				
-					guc_OLED_Buf[X_dot][Y_dot/8 + 1] = fbm1h;		
+					guc_OLED_Buf[Y_dot/8 + 1][X_dot] = fbm1h;		
 				
 				}
 				else
 				{
 					fbm19h = 0x00FF;
 				
-					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[X_dot][Y_dot/8];
+					fbm1h = (((unsigned short)fbm19h) >> (8-Y_Bias)) & guc_OLED_Buf[Y_dot/8][X_dot];
 					fbm1h |= fbm2h<<Y_Bias;			
-					guc_OLED_Buf[X_dot][Y_dot/8] = fbm1h;
+					guc_OLED_Buf[Y_dot/8][X_dot] = fbm1h;
 
 					fbm1h = ( (((unsigned char)fbm2h) >> (8-Y_Bias)) | (fbm3h << Y_Bias));	
-					guc_OLED_Buf[X_dot][Y_dot/8 + 1] = fbm1h;			
+					guc_OLED_Buf[Y_dot/8 + 1][X_dot] = fbm1h;			
 
-					fbm1h = guc_OLED_Buf[X_dot][Y_dot/8 + 2] & (fbm19h << (5-(8-Y_Bias)));
+					fbm1h = guc_OLED_Buf[Y_dot/8 + 2][X_dot] & (fbm19h << (5-(8-Y_Bias)));
 							
 					fbm1h |= (((unsigned char)fbm3h) >> (8-Y_Bias));
-					guc_OLED_Buf[X_dot][Y_dot/8 + 2] = fbm1h;	
+					guc_OLED_Buf[Y_dot/8 + 2][X_dot] = fbm1h;	
 				}
 
 				X_dot++;
@@ -833,6 +1141,8 @@ void func_display_string(uint8_t X_dot,uint8_t Y_dot,signed short *text)
 		
 		sPosi++;
 	}
+	//字符最多跨越3页
+	OLED_Mark_Dirty(ucStartX, Y_dot / 8U, X_dot - ucStartX, 3U);
 }
 
 /******************************************************************************
@@ -25,6 +25,7 @@ extern "C"
 //#include "drv_IIC.h"
 #include "hc32_ll_gpio.h"
 #include "com.h"
+#include "Bitmap.h"
 /*******************************************************************************
  * Global pre-processor symbols/macros ('#define')
  ******************************************************************************/
@@ -42,6 +43,30 @@ extern "C"
 #define  OLED_IIC_SdaState             GPIO_ReadInputPins(OLED_IIC_SDA_PORT,OLED_IIC_SDA_PIN)
 #define  OLED_IIC_SclState             GPIO_ReadOutputPins(OLED_IIC_SCL_PORT,OLED_IIC_SCL_PIN)
 
+//OLED 传输方式
+#define OLED_TRANS_GPIO			(0U)	//GPIO 模拟串行时序
+#define OLED_TRANS_SPI_DMA		(1U)	//SPI3 + DMA2 CH1, SCL/SDA 复用为 SCK/MOSI
+#define OLED_TRANS_HOST			(2U)	//PC 上编译(tools/host_display), 页写入交给 OLED_Host_Write_Page
+#ifndef OLED_TRANS
+#define OLED_TRANS				(OLED_TRANS_SPI_DMA)
+#endif
+
+#define OLED_SPI_UNIT			(CM_SPI3)
+#define OLED_SPI_PERIPH_CLK		(FCG1_PERIPH_SPI3)
+#define OLED_SPI_SCK_PIN_FUNC	(GPIO_FUNC_43)	//SPI3 SCK  on OLED_IIC_SCL
+#define OLED_SPI_MOSI_PIN_FUNC	(GPIO_FUNC_40)	//SPI3 MOSI on OLED_IIC_SDA
+#define OLED_SPI_BR_CLK_DIV		(SPI_BR_CLK_DIV16)	//PCLK1(100MHz) / 16 = 6.25MHz
+#define OLED_SPI_TIMEOUT		(100000UL)
+
+#define OLED_DMA_UNIT			(CM_DMA2)
+#define OLED_DMA_FCG_ENABLE()	(FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_DMA2 | FCG0_PERIPH_AOS, ENABLE))
+#define OLED_DMA_CH				(DMA_CH1)
+#define OLED_DMA_TRIG_SEL		(AOS_DMA2_1)
+#define OLED_DMA_TRIG_EVT_SRC	(EVT_SRC_SPI3_SPTI)
+#define OLED_DMA_TC_FLAG		(DMA_FLAG_TC_CH1)
+//少于该字节数时轮询发送
+#define OLED_DMA_MIN_LEN		(8UL)
+
 #ifdef HW_VERSION_V1_1
 #define PWRLCM_GPIO_PORT	GPIO_PORT_E
 #define PWRLCM_GPIO_PIN	  GPIO_PIN_11
@@ -90,16 +115,24 @@ extern void OLED_Write_Data(uint8_t uData);
 extern uint8_t drv_OLED_Init(void);
 extern void OLED_Test(uint8_t ucType);
 extern void func_display_string(uint8_t X_dot,uint8_t Y_dot,signed short *text);
+extern void func_display_digit(uint8_t X_dot, uint8_t Y_dot, uint8_t ucDigit);
+extern void OLED_Draw_Bitmap(const BitmapSt *pstBitmap);
 
 extern void func_OLED_PowerUp_Init(void);
 extern void func_OLED_PowerDown_DeInit(void);
+extern void OLED_Set_Contrast(uint8_t ucContrast);
+extern void OLED_Display_Switch(uint8_t ucOn);
 
+extern void OLED_Mark_Dirty(uint8_t ucColumn, uint8_t ucPage, uint8_t ucWidth, uint8_t ucPages);
+#if (OLED_TRANS == OLED_TRANS_HOST)
+extern void OLED_Host_Write_Page(uint8_t ucPage, uint8_t ucColumn, const uint8_t *pu8Data, uint8_t ucLen);
+#endif
 extern void clear_screen();
 extern void display_128x64(uint8_t *dp) ;
 extern void func_Display_128x64();
 
 //extern SystemPataSt *pst_OLEDSystemPara;
-extern unsigned char guc_OLED_Buf[128][8];	//OLED显示数据缓存;8*8=64行128列
+extern unsigned char guc_OLED_Buf[8][128];	//OLED显示数据缓存;8*8=64行128列, [页][列]
 
 #ifdef __cplusplus
 }
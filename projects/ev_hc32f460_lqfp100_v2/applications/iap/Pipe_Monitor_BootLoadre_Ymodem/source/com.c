@@ -52,6 +52,9 @@
 #define RX_DMA_TC_IRQn                  (INT000_IRQn)
 #define RX_DMA_TC_INT_SRC               (INT_SRC_DMA1_TC0)
 
+/* Ring receive (YModem), RX DMA in destination repeat mode, max 1024 */
+#define RX_RING_SIZE                    (1024U)
+
 /* Timer0 unit & channel definition */
 #define TMR0_UNIT                       (CM_TMR0_1)
 #define TMR0_CH                         (TMR0_CH_A)
@@ -103,6 +106,8 @@ static __IO en_flag_status_t m_enRxFrameEnd;
 uint16_t m_u16RxLen = 0;
 uint8_t m_RecvFlag = 0;
 uint8_t m_au8RxBuf[APP_FRAME_LEN_MAX] = {0};
+static uint8_t m_au8RingBuf[RX_RING_SIZE];
+static uint16_t m_u16RingRead = 0U;	/* Next byte to be read from m_au8RingBuf */
 
 /*******************************************************************************
  * Function implementation - global ('extern') and local ('static')
@@ -401,6 +406,103 @@ int32_t COM_RecvData(uint8_t *pu8Buff, uint16_t u16Len, uint32_t u32Timeout)
     return LL_OK;
 }
 
+/**
+ * @brief  Switch the RX DMA from frame receive to ring receive.
+ * @param  None
+ * @retval None
+ * @note   The RX DMA writes every received byte into m_au8RingBuf without
+ *         CPU help, so bytes keep arriving while the CPU programs flash.
+ *         The ring is not overrun checked: more than RX_RING_SIZE unread
+ *         bytes corrupt the stream, which the YModem CRC then rejects.
+ */
+void COM_RingStart(void)
+{
+    stc_dma_init_t stcDmaInit;
+    stc_dma_repeat_init_t stcDmaRptInit;
+
+    /* No RX timeout, no LLP reload of the frame buffer */
+    USART_FuncCmd(USART_UNIT, (USART_RX_TIMEOUT | USART_INT_RX_TIMEOUT), DISABLE);
+    DMA_TransCompleteIntCmd(RX_DMA_UNIT, RX_DMA_TC_INT, DISABLE);
+    (void)DMA_ChCmd(RX_DMA_UNIT, RX_DMA_CH, DISABLE);
+    DMA_ReconfigLlpCmd(RX_DMA_UNIT, RX_DMA_CH, DISABLE);
+    DMA_LlpCmd(RX_DMA_UNIT, RX_DMA_CH, DISABLE);
+
+    (void)DMA_StructInit(&stcDmaInit);
+    stcDmaInit.u32IntEn = DMA_INT_DISABLE;
+    stcDmaInit.u32BlockSize = 1UL;
+    stcDmaInit.u32TransCount = 0UL;     /* 0: no limit */
+    stcDmaInit.u32DataWidth = DMA_DATAWIDTH_8BIT;
+    stcDmaInit.u32DestAddr = (uint32_t)m_au8RingBuf;
+    stcDmaInit.u32SrcAddr = (uint32_t)(&USART_UNIT->RDR);
+    stcDmaInit.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    stcDmaInit.u32DestAddrInc = DMA_DEST_ADDR_INC;
+    (void)DMA_Init(RX_DMA_UNIT, RX_DMA_CH, &stcDmaInit);
+
+    (void)DMA_RepeatStructInit(&stcDmaRptInit);
+    stcDmaRptInit.u32Mode = DMA_RPT_DEST;
+    stcDmaRptInit.u32DestCount = RX_RING_SIZE;
+    (void)DMA_RepeatInit(RX_DMA_UNIT, RX_DMA_CH, &stcDmaRptInit);
+
+    m_u16RingRead = 0U;
+    (void)DMA_ChCmd(RX_DMA_UNIT, RX_DMA_CH, ENABLE);
+}
+
+/**
+ * @brief  Switch the RX DMA back to frame receive.
+ * @param  None
+ * @retval None
+ */
+void COM_RingStop(void)
+{
+    stc_dma_repeat_init_t stcDmaRptInit;
+
+    (void)DMA_ChCmd(RX_DMA_UNIT, RX_DMA_CH, DISABLE);
+    (void)DMA_RepeatStructInit(&stcDmaRptInit);
+    (void)DMA_RepeatInit(RX_DMA_UNIT, RX_DMA_CH, &stcDmaRptInit);
+    m_enRxFrameEnd = RESET;
+    m_RecvFlag = 0U;
+    (void)DMA_Config();
+    USART_FuncCmd(USART_UNIT, (USART_RX_TIMEOUT | USART_INT_RX_TIMEOUT), ENABLE);
+}
+
+/**
+ * @brief  COM receive data from the ring.
+ * @param  [out] pu8Buff                Pointer to the buffer to be received
+ * @param  [in]  u16Len                 Receive data length
+ * @param  [in]  u32Timeout             Receive timeout(ms)
+ * @retval int32_t:
+ *           - LL_OK: Receive data finished
+ *           - LL_ERR: Receive timeout
+ *           - LL_ERR_INVD_PARAM: u32Len value is 0 or the pointer pvBuf value is NULL.
+ * @note   Only valid between COM_RingStart() and COM_RingStop().
+ */
+int32_t COM_RingRead(uint8_t *pu8Buff, uint16_t u16Len, uint32_t u32Timeout)
+{
+    uint32_t u32Tick;
+    uint16_t u16Write;
+
+    if ((NULL == pu8Buff) || (0U == u16Len)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    u32Tick = SysTick_GetTick();
+    while (u16Len != 0U) {
+        u16Write = (uint16_t)((DMA_GetDestAddr(RX_DMA_UNIT, RX_DMA_CH) - (uint32_t)m_au8RingBuf) % RX_RING_SIZE);
+        if (u16Write == m_u16RingRead) {
+            if ((SysTick_GetTick() - u32Tick) >= u32Timeout) {
+                return LL_ERR;
+            }
+            continue;
+        }
+        while ((u16Write != m_u16RingRead) && (u16Len != 0U)) {
+            *pu8Buff++ = m_au8RingBuf[m_u16RingRead];
+            m_u16RingRead = (m_u16RingRead + 1U) % RX_RING_SIZE;
+            u16Len--;
+        }
+    }
+    return LL_OK;
+}
+
 /******************************************************************************
  * EOF (not truncated)
  *****************************************************************************/
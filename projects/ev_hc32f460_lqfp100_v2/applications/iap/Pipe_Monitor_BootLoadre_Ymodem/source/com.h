@@ -30,6 +30,7 @@ extern "C"
 #include "hc32_ll_aos.h"
 #include "hc32_ll_tmr0.h"
 #include "hc32_ll_interrupts.h"
+#include "hc32_ll_utility.h"
 /*******************************************************************************
  * Global type definitions ('typedef')
  ******************************************************************************/
@@ -83,6 +84,9 @@ void COM_DeInit(void);
 void COM_Init(void);
 void COM_SendData(uint8_t *pu8Buff, uint16_t u16Len);
 int32_t COM_RecvData(uint8_t *pu8Buff, uint16_t u16Len, uint32_t u32Timeout);
+void COM_RingStart(void);
+void COM_RingStop(void);
+int32_t COM_RingRead(uint8_t *pu8Buff, uint16_t u16Len, uint32_t u32Timeout);
 
 #ifdef __cplusplus
 }
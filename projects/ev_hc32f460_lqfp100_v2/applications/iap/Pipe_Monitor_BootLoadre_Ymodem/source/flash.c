@@ -14,14 +14,49 @@
  * Include files
  ******************************************************************************/
 #include "flash.h"
+#include "main.h"
+#include "string.h"
 
 /*******************************************************************************
  * Local type definitions ('typedef')
  ******************************************************************************/
+/* Background erase job */
+typedef struct {
+    uint32_t u32StartAddr;              /* First sector of the job not yet handed to a writer */
+    uint32_t u32EndAddr;                /* End (exclusive) of the job */
+    __IO uint32_t u32Addr;              /* Sector being erased, all below are done */
+    __IO int32_t i32Status;             /* LL_ERR_BUSY while running */
+    uint32_t u32Cache;                  /* Cache setting to restore */
+    uint32_t u32KickCycle;              /* Cycle count when the current sector started */
+    func_flash_erase_cb_t pfnCallback;
+    __IO uint8_t u8Hold;                /* Set around program bursts, no new sector is started */
+    __IO uint8_t u8Paused;              /* Next sector held back by u8Hold */
+} stc_flash_erase_job_t;
 
 /*******************************************************************************
  * Local pre-processor symbols/macros ('#define')
  ******************************************************************************/
+/* Background erase interrupt */
+#define FLASH_ERASE_IRQn                (INT005_IRQn)
+#define FLASH_ERASE_INT_SRC             (INT_SRC_EFM_OPTEND)
+/* Max time for one sector erase to finish (ms) */
+#define FLASH_ERASE_TIMEOUT_MS          (50UL)
+#define FLASH_ERASE_ERR_FLAG            (EFM_FLAG_PEWERR | EFM_FLAG_PEPRTERR | EFM_FLAG_PGSZERR)
+
+/* Program verify: flash range is fed into the CRC unit by DMA2 CH0 */
+#define FLASH_VERIFY_DMA_UNIT           (CM_DMA2)
+#define FLASH_VERIFY_DMA_CH             (DMA_CH0)
+#define FLASH_VERIFY_DMA_MX_CH          (DMA_MX_CH0)
+#define FLASH_VERIFY_DMA_TC_FLAG        (DMA_FLAG_TC_CH0)
+#define FLASH_VERIFY_DMA_FCG_ENABLE()   (FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_DMA2 | FCG0_PERIPH_CRC, ENABLE))
+#define FLASH_VERIFY_DMA_BLOCK_MAX      (1024UL)
+#define FLASH_VERIFY_TIMEOUT            (HCLK_VALUE / 1000UL)
+
+/* Program bursts shorter than this are not timed (call overhead dominates) */
+#define FLASH_STATS_PROG_MIN            (256UL)
+
+/* Size of the block programmed by FLASH_Benchmark() */
+#define FLASH_BENCH_SIZE                (1024UL)
 
 /*******************************************************************************
  * Global variable definitions (declared in header file with 'extern')
@@ -30,10 +65,23 @@
 /*******************************************************************************
  * Local function prototypes ('static')
  ******************************************************************************/
+static int32_t FLASH_WriterPrepare(stc_flash_writer_t *pstcWriter, uint32_t u32EndAddr);
+static void FLASH_EraseKick(uint32_t u32Addr);
+static int32_t FLASH_ProgramVerify(uint32_t u32Addr, const uint8_t *pu8Buff, uint32_t u32Len);
+static int32_t FLASH_EraseOne(uint32_t u32Addr);
+static int32_t FLASH_EraseHold(void);
+static void FLASH_EraseResume(void);
+static int32_t FLASH_WriterProgram(uint32_t u32Addr, const uint8_t *pu8Buff, uint32_t u32Len);
+static void FLASH_StatsAdd(uint32_t *pu32Min, uint32_t *pu32Max, uint32_t *pu32Avg, uint32_t u32Value);
+static void FLASH_StatsErase(uint32_t u32Addr, uint32_t u32Us);
+static void FLASH_EraseOptEnd_IrqCallback(void);
 
 /*******************************************************************************
  * Local variable definitions ('static')
  ******************************************************************************/
+static stc_flash_erase_job_t m_stcEraseJob = {0UL, 0UL, 0UL, LL_OK, 0UL, 0UL, NULL, 0U, 0U};
+static stc_flash_stats_t m_stcStats;
+static uint8_t m_u8VerifyInit = 0U;
 
 /*******************************************************************************
  * Function implementation - global ('extern') and local ('static')
@@ -76,16 +124,19 @@ int32_t FLASH_EraseSector(uint32_t u32Addr, uint32_t u32Size)
     if (u32Addr >= (FLASH_BASE + FLASH_SIZE)) {
         return LL_ERR_INVD_PARAM;
     }
+    if (LL_ERR_TIMEOUT == FLASH_WaitEraseDone()) {
+        return LL_ERR;
+    }
 
     if (u32Size == 0U) {
-        return EFM_SectorErase(u32Addr);
+        return FLASH_EraseOne(u32Addr);
     } else {
         u32PageNum = u32Size / FLASH_SECTOR_SIZE;
         if ((u32Size % FLASH_SECTOR_SIZE) != 0UL) {
             u32PageNum += 1U;
         }
         for (i = 0; i < u32PageNum; i++) {
-            if (LL_OK != EFM_SectorErase(u32Addr + (i * FLASH_SECTOR_SIZE))) {
+            if (LL_OK != FLASH_EraseOne(u32Addr + (i * FLASH_SECTOR_SIZE))) {
                 return LL_ERR;
             }
         }
@@ -103,7 +154,13 @@ int32_t FLASH_EraseSector(uint32_t u32Addr, uint32_t u32Size)
  *           - LL_OK: Program successful.
  *           - LL_ERR_INVD_PARAM: The parameters is invalid.
  *           - LL_ERR_NOT_RDY: EFM if not ready.
+ *           - LL_ERR_TIMEOUT: Program timeout
  *           - LL_ERR_ADDR_ALIGN: Address alignment error
+ *           - LL_ERR: Verify failed
+ * @note   Programs in sequence program mode from RAM (EFM_SequenceProgram is
+ *         __RAM_FUNC), pu8Buff must not point into flash. The programmed
+ *         range is verified by CRC32 (see FLASH_VerifyData). A running
+ *         background erase is waited for first.
  */
 int32_t FLASH_WriteData(uint32_t u32Addr, uint8_t *pu8Buff, uint32_t u32Len)
 {
@@ -113,7 +170,12 @@ int32_t FLASH_WriteData(uint32_t u32Addr, uint8_t *pu8Buff, uint32_t u32Len)
     if (0UL != (u32Addr % 4U)) {
         return LL_ERR_ADDR_ALIGN;
     }
-    return EFM_Program(u32Addr, pu8Buff, u32Len);
+    if (LL_ERR_TIMEOUT == FLASH_WaitEraseDone()) {
+        return LL_ERR_TIMEOUT;
+    }
+    /* Direct programming uses up whatever is left of a finished erase job */
+    m_stcEraseJob.u32StartAddr = m_stcEraseJob.u32EndAddr;
+    return FLASH_ProgramVerify(u32Addr, pu8Buff, u32Len);
 }
 
 /**
@@ -161,6 +223,754 @@ int32_t FLASH_ReadData(uint32_t u32Addr, uint8_t *pu8Buff, uint32_t u32Len)
     return LL_OK;
 }
 
+/**
+ * @brief  Erase one sector and record its erase time.
+ * @param  u32Addr                      Address in the sector
+ * @retval int32_t:
+ *           - LL_OK: Erase succeeded
+ *           - LL_ERR_NOT_RDY: EFM is not ready.
+ */
+static int32_t FLASH_EraseOne(uint32_t u32Addr)
+{
+    int32_t i32Ret;
+    uint32_t u32Cycle;
+
+    u32Cycle = IAP_GetCycleCount();
+    i32Ret = EFM_SectorErase(u32Addr);
+    if (LL_OK == i32Ret) {
+        FLASH_StatsErase(u32Addr, IAP_CYCLE_TO_US(IAP_GetCycleCount() - u32Cycle));
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Add a sample to a min/max/rolling average triple.
+ * @param  pu32Min                      Pointer to the minimum
+ * @param  pu32Max                      Pointer to the maximum
+ * @param  pu32Avg                      Pointer to the rolling average
+ * @param  u32Value                     New sample
+ * @retval None
+ */
+static void FLASH_StatsAdd(uint32_t *pu32Min, uint32_t *pu32Max, uint32_t *pu32Avg, uint32_t u32Value)
+{
+    if ((*pu32Min == 0UL) || (u32Value < *pu32Min)) {
+        *pu32Min = u32Value;
+    }
+    if (u32Value > *pu32Max) {
+        *pu32Max = u32Value;
+    }
+    if (*pu32Avg == 0UL) {
+        *pu32Avg = u32Value;
+    } else {
+        *pu32Avg = (*pu32Avg - (*pu32Avg / 8UL)) + (u32Value / 8UL);
+    }
+}
+
+/**
+ * @brief  Record a finished sector erase.
+ * @param  u32Addr                      Address in the sector
+ * @param  u32Us                        Erase time (us)
+ * @retval None
+ */
+static void FLASH_StatsErase(uint32_t u32Addr, uint32_t u32Us)
+{
+    uint32_t u32Sector = (u32Addr - FLASH_BASE) / FLASH_SECTOR_SIZE;
+
+    if (u32Sector < FLASH_SECTOR_NUM) {
+        m_stcStats.au32EraseCnt[u32Sector]++;
+    }
+    FLASH_StatsAdd(&m_stcStats.u32EraseMin, &m_stcStats.u32EraseMax, &m_stcStats.u32EraseAvg, u32Us);
+}
+
+/**
+ * @brief  Load the newest statistics record from flash.
+ * @param  None
+ * @retval None
+ * @note   Starts from zero when no valid record is found.
+ */
+void FLASH_StatsLoad(void)
+{
+    uint32_t i;
+    const stc_flash_stats_t *pstcSlot;
+
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+    for (i = 0UL; i < FLASH_STATS_SLOT_NUM; i++) {
+        pstcSlot = (const stc_flash_stats_t *)(FLASH_STATS_ADDR + (i * FLASH_STATS_SLOT_SIZE));
+        if (pstcSlot->u32Magic == FLASH_STATS_MAGIC) {
+            (void)memcpy(&m_stcStats, pstcSlot, sizeof(m_stcStats));
+        }
+    }
+    m_stcStats.u32Magic = FLASH_STATS_MAGIC;
+}
+
+/**
+ * @brief  Save the statistics into the next blank record slot.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK: Saved
+ *           - LL_ERR: Erase or verify failed
+ *           - LL_ERR_NOT_RDY: EFM is not ready.
+ *           - LL_ERR_TIMEOUT: A running background erase did not finish
+ * @note   Nothing else erases the statistics sector. When every slot is used
+ *         it is erased here and the record starts again in the first slot.
+ */
+int32_t FLASH_StatsSave(void)
+{
+    uint32_t i;
+    uint32_t u32Slot;
+
+    if (LL_ERR_TIMEOUT == FLASH_WaitEraseDone()) {
+        return LL_ERR_TIMEOUT;
+    }
+
+    for (i = 0UL; i < FLASH_STATS_SLOT_NUM; i++) {
+        u32Slot = FLASH_STATS_ADDR + (i * FLASH_STATS_SLOT_SIZE);
+        if (RW_MEM32(u32Slot) == 0xFFFFFFFFUL) {
+            return FLASH_ProgramVerify(u32Slot, (const uint8_t *)&m_stcStats, sizeof(m_stcStats));
+        }
+    }
+
+    /* The erase is counted before the record is written */
+    if (LL_OK != FLASH_EraseOne(FLASH_STATS_ADDR)) {
+        return LL_ERR;
+    }
+    return FLASH_ProgramVerify(FLASH_STATS_ADDR, (const uint8_t *)&m_stcStats, sizeof(m_stcStats));
+}
+
+/**
+ * @brief  Get the live statistics.
+ * @param  None
+ * @retval Pointer to the statistics
+ */
+const stc_flash_stats_t *FLASH_GetStats(void)
+{
+    return &m_stcStats;
+}
+
+/**
+ * @brief  Program flash and verify the programmed range.
+ * @param  u32Addr                      Word aligned flash address
+ * @param  pu8Buff                      Pointer to the data (in RAM)
+ * @param  u32Len                       Data length
+ * @retval int32_t:
+ *           - LL_OK: Program and verify succeeded
+ *           - LL_ERR: Verify failed
+ *           - Other: Error returned by EFM_SequenceProgram
+ */
+static int32_t FLASH_ProgramVerify(uint32_t u32Addr, const uint8_t *pu8Buff, uint32_t u32Len)
+{
+    int32_t i32Ret;
+    uint32_t u32Cycle;
+    uint32_t u32Us;
+
+    u32Cycle = IAP_GetCycleCount();
+    i32Ret = EFM_SequenceProgram(u32Addr, pu8Buff, u32Len);
+    if (LL_OK == i32Ret) {
+        if (u32Len >= FLASH_STATS_PROG_MIN) {
+            u32Us = IAP_CYCLE_TO_US(IAP_GetCycleCount() - u32Cycle);
+            FLASH_StatsAdd(&m_stcStats.u32ProgMin, &m_stcStats.u32ProgMax, &m_stcStats.u32ProgAvg,
+                           (u32Us * 1024UL) / u32Len);
+        }
+        i32Ret = FLASH_VerifyData(u32Addr, pu8Buff, u32Len);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Verify flash content against a buffer with the CRC unit.
+ * @param  u32Addr                      Flash address
+ * @param  pu8Buff                      Pointer to the expected data
+ * @param  u32Len                       Data length
+ * @retval int32_t:
+ *           - LL_OK: Content matches
+ *           - LL_ERR: Content differs
+ *           - LL_ERR_TIMEOUT: DMA timeout
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ *           - LL_ERR_ADDR_ALIGN: Address alignment error
+ * @note   The whole words of the flash range are streamed into the CRC data
+ *         register by DMA, so no second RAM buffer is needed.
+ */
+int32_t FLASH_VerifyData(uint32_t u32Addr, const uint8_t *pu8Buff, uint32_t u32Len)
+{
+    stc_crc_init_t stcCrcInit;
+    stc_dma_init_t stcDmaInit;
+    uint32_t u32Words = u32Len / 4U;
+    uint32_t u32Tail = u32Len % 4U;
+    uint32_t u32Block;
+    uint32_t u32Src = u32Addr;
+    uint32_t u32Timeout;
+    uint32_t u32SrcCrc = 0UL;
+    uint32_t u32FlashCrc = 0UL;
+
+    if ((pu8Buff == NULL) || (u32Len == 0U) || ((u32Addr + u32Len) > (FLASH_BASE + FLASH_SIZE))) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (0UL != (u32Addr % 4U)) {
+        return LL_ERR_ADDR_ALIGN;
+    }
+
+    if (m_u8VerifyInit == 0U) {
+        FLASH_VERIFY_DMA_FCG_ENABLE();
+        DMA_Cmd(FLASH_VERIFY_DMA_UNIT, ENABLE);
+        m_u8VerifyInit = 1U;
+    }
+    /* The YModem packet check leaves the CRC unit in CRC16 mode */
+    (void)CRC_StructInit(&stcCrcInit);
+    stcCrcInit.u32Protocol = CRC_CRC32;
+    (void)CRC_Init(&stcCrcInit);
+
+    /* CRC of the source data */
+    if (u32Words != 0UL) {
+        (void)CRC_CRC32_Calculate(CRC_INIT_VALUE_DEFAULT, CRC_DATA_WIDTH_32BIT, pu8Buff, u32Words, &u32SrcCrc);
+    } else {
+        CRC_SetInitValue(CRC_INIT_VALUE_DEFAULT);
+    }
+    if (u32Tail != 0UL) {
+        (void)CRC_CRC32_AccumulateData(CRC_DATA_WIDTH_8BIT, &pu8Buff[u32Words * 4U], u32Tail, &u32SrcCrc);
+    }
+
+    /* CRC of the flash range */
+    CRC_SetInitValue(CRC_INIT_VALUE_DEFAULT);
+    (void)DMA_StructInit(&stcDmaInit);
+    stcDmaInit.u32IntEn       = DMA_INT_DISABLE;
+    stcDmaInit.u32TransCount  = 1UL;
+    stcDmaInit.u32DataWidth   = DMA_DATAWIDTH_32BIT;
+    stcDmaInit.u32DestAddr    = (uint32_t)&CM_CRC->DAT0;
+    stcDmaInit.u32SrcAddrInc  = DMA_SRC_ADDR_INC;
+    stcDmaInit.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+    while (u32Words != 0UL) {
+        u32Block = (u32Words > FLASH_VERIFY_DMA_BLOCK_MAX) ? FLASH_VERIFY_DMA_BLOCK_MAX : u32Words;
+        stcDmaInit.u32SrcAddr   = u32Src;
+        stcDmaInit.u32BlockSize = u32Block;
+        (void)DMA_Init(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_CH, &stcDmaInit);
+        DMA_ClearTransCompleteStatus(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_TC_FLAG);
+        (void)DMA_ChCmd(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_CH, ENABLE);
+        DMA_MxChSWTrigger(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_MX_CH);
+
+        u32Timeout = 0UL;
+        while (SET != DMA_GetTransCompleteStatus(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_TC_FLAG)) {
+            if (u32Timeout++ >= FLASH_VERIFY_TIMEOUT) {
+                (void)DMA_ChCmd(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_CH, DISABLE);
+                return LL_ERR_TIMEOUT;
+            }
+        }
+        DMA_ClearTransCompleteStatus(FLASH_VERIFY_DMA_UNIT, FLASH_VERIFY_DMA_TC_FLAG);
+        u32Src   += u32Block * 4U;
+        u32Words -= u32Block;
+    }
+    if (u32Tail != 0UL) {
+        (void)CRC_CRC32_AccumulateData(CRC_DATA_WIDTH_8BIT, (const uint8_t *)u32Src, u32Tail, NULL);
+    }
+    u32FlashCrc = CRC_GetResult();
+
+    return (u32FlashCrc == u32SrcCrc) ? LL_OK : LL_ERR;
+}
+
+/**
+ * @brief  Hold the background erase job so the EFM can be used for programming.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK: No sector erase is in flight
+ *           - LL_ERR_TIMEOUT: The running sector erase did not finish
+ * @note   Always pair with FLASH_EraseResume(), also after a timeout.
+ */
+static int32_t FLASH_EraseHold(void)
+{
+    uint32_t u32Tick;
+
+    m_stcEraseJob.u8Hold = 1U;
+    u32Tick = SysTick_GetTick();
+    while ((m_stcEraseJob.i32Status == LL_ERR_BUSY) && (m_stcEraseJob.u8Paused == 0U)) {
+        if ((SysTick_GetTick() - u32Tick) > FLASH_ERASE_TIMEOUT_MS) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Release the background erase job and restart a parked sector.
+ * @param  None
+ * @retval None
+ */
+static void FLASH_EraseResume(void)
+{
+    m_stcEraseJob.u8Hold = 0U;
+    if (m_stcEraseJob.u8Paused != 0U) {
+        m_stcEraseJob.u8Paused = 0U;
+        /* Drop the OPTEND left by the program burst before unmasking it */
+        WRITE_REG32(CM_EFM->FSCLR, EFM_FLAG_ALL);
+        SET_REG32_BIT(CM_EFM->FITE, EFM_INT_OPTEND);
+        NVIC_ClearPendingIRQ(FLASH_ERASE_IRQn);
+        FLASH_EraseKick(m_stcEraseJob.u32Addr);
+    }
+}
+
+/**
+ * @brief  Program and verify a writer burst with the background erase held.
+ * @param  u32Addr                      Flash address
+ * @param  pu8Buff                      Pointer to the data
+ * @param  u32Len                       Data length
+ * @retval int32_t:
+ *           - LL_OK: Program and verify succeeded
+ *           - Other: Error from FLASH_EraseHold() or FLASH_ProgramVerify()
+ */
+static int32_t FLASH_WriterProgram(uint32_t u32Addr, const uint8_t *pu8Buff, uint32_t u32Len)
+{
+    int32_t i32Ret;
+
+    i32Ret = FLASH_EraseHold();
+    if (LL_OK == i32Ret) {
+        i32Ret = FLASH_ProgramVerify(u32Addr, pu8Buff, u32Len);
+    }
+    FLASH_EraseResume();
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Erase the sectors a writer is about to enter.
+ * @param  pstcWriter                   Pointer to the writer
+ * @param  u32EndAddr                   End address (exclusive) of the next program burst
+ * @retval int32_t:
+ *           - LL_OK: All sectors below u32EndAddr are erased
+ *           - LL_ERR_INVD_PARAM: The range runs past the end of flash
+ *           - LL_ERR_NOT_RDY: EFM is not ready.
+ */
+static int32_t FLASH_WriterPrepare(stc_flash_writer_t *pstcWriter, uint32_t u32EndAddr)
+{
+    int32_t i32Ret;
+
+    while (pstcWriter->u32EraseAddr < u32EndAddr) {
+        if (pstcWriter->u32EraseAddr >= (FLASH_BASE + FLASH_SIZE)) {
+            return LL_ERR_INVD_PARAM;
+        }
+        /* Sectors of a background erase job are only waited for, and are taken
+           out of the job so no later writer trusts them to be blank */
+        i32Ret = FLASH_WaitEraseSector(pstcWriter->u32EraseAddr);
+        if (LL_OK == i32Ret) {
+            m_stcEraseJob.u32StartAddr = pstcWriter->u32EraseAddr + FLASH_SECTOR_SIZE;
+        } else if (LL_ERR_INVD_PARAM == i32Ret) {
+            i32Ret = FLASH_EraseHold();
+            if (LL_OK == i32Ret) {
+                i32Ret = FLASH_EraseOne(pstcWriter->u32EraseAddr);
+            }
+            FLASH_EraseResume();
+        }
+        if (LL_OK != i32Ret) {
+            return i32Ret;
+        }
+        pstcWriter->u32EraseAddr += FLASH_SECTOR_SIZE;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Open a streaming writer.
+ * @param  pstcWriter                   Pointer to the writer
+ * @param  u32Addr                      Flash address of the first byte, any alignment
+ * @retval int32_t:
+ *           - LL_OK: Writer ready
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ * @note   The sector holding u32Addr is erased on first use only when u32Addr is
+ *         sector aligned; otherwise the rest of that sector must already be blank.
+ */
+int32_t FLASH_WriterOpen(stc_flash_writer_t *pstcWriter, uint32_t u32Addr)
+{
+    uint8_t i;
+
+    if ((pstcWriter == NULL) || (u32Addr >= (FLASH_BASE + FLASH_SIZE))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    pstcWriter->u32Addr   = u32Addr & ~3UL;
+    pstcWriter->u8WordLen = (uint8_t)(u32Addr & 3UL);
+    pstcWriter->u32Total  = 0UL;
+    /* Leading bytes of an unaligned word are programmed as 0xFF (left untouched) */
+    for (i = 0U; i < pstcWriter->u8WordLen; i++) {
+        pstcWriter->au8Word[i] = 0xFFU;
+    }
+    if ((u32Addr % FLASH_SECTOR_SIZE) == 0UL) {
+        pstcWriter->u32EraseAddr = u32Addr;
+    } else {
+        pstcWriter->u32EraseAddr = (u32Addr - (u32Addr % FLASH_SECTOR_SIZE)) + FLASH_SECTOR_SIZE;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Append data to a streaming writer.
+ * @param  pstcWriter                   Pointer to the writer
+ * @param  pu8Buff                      Pointer to the data, any alignment
+ * @param  u32Len                       Data length, any size
+ * @retval int32_t:
+ *           - LL_OK: Data accepted
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ *           - LL_ERR_NOT_RDY: EFM is not ready.
+ * @note   Whole words are programmed directly from pu8Buff without an extra copy,
+ *         up to three trailing bytes are kept until the next append or flush.
+ *         pu8Buff must not point into flash (see FLASH_WriteData).
+ */
+int32_t FLASH_WriterAppend(stc_flash_writer_t *pstcWriter, const uint8_t *pu8Buff, uint32_t u32Len)
+{
+    int32_t i32Ret;
+    uint32_t u32Words;
+
+    if ((pstcWriter == NULL) || (pu8Buff == NULL) ||
+        ((pstcWriter->u32Addr + pstcWriter->u8WordLen + u32Len) > (FLASH_BASE + FLASH_SIZE))) {
+        return LL_ERR_INVD_PARAM;
+    }
+    pstcWriter->u32Total += u32Len;
+
+    /* Complete the pending word first */
+    if (pstcWriter->u8WordLen != 0U) {
+        while ((pstcWriter->u8WordLen < 4U) && (u32Len != 0UL)) {
+            pstcWriter->au8Word[pstcWriter->u8WordLen++] = *pu8Buff++;
+            u32Len--;
+        }
+        if (pstcWriter->u8WordLen < 4U) {
+            return LL_OK;
+        }
+        i32Ret = FLASH_WriterPrepare(pstcWriter, pstcWriter->u32Addr + 4UL);
+        if (LL_OK == i32Ret) {
+            i32Ret = FLASH_WriterProgram(pstcWriter->u32Addr, pstcWriter->au8Word, 4UL);
+        }
+        if (LL_OK != i32Ret) {
+            return i32Ret;
+        }
+        pstcWriter->u32Addr += 4UL;
+        pstcWriter->u8WordLen = 0U;
+    }
+
+    /* Program whole words in one burst straight from the caller's buffer */
+    u32Words = u32Len & ~3UL;
+    if (u32Words != 0UL) {
+        i32Ret = FLASH_WriterPrepare(pstcWriter, pstcWriter->u32Addr + u32Words);
+        if (LL_OK == i32Ret) {
+            i32Ret = FLASH_WriterProgram(pstcWriter->u32Addr, pu8Buff, u32Words);
+        }
+        if (LL_OK != i32Ret) {
+            return i32Ret;
+        }
+        pstcWriter->u32Addr += u32Words;
+        pu8Buff += u32Words;
+        u32Len  -= u32Words;
+    }
+
+    /* Hold back the tail */
+    while (u32Len != 0UL) {
+        pstcWriter->au8Word[pstcWriter->u8WordLen++] = *pu8Buff++;
+        u32Len--;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Program the pending partial word of a streaming writer.
+ * @param  pstcWriter                   Pointer to the writer
+ * @retval int32_t:
+ *           - LL_OK: Flush succeeded
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ *           - LL_ERR_NOT_RDY: EFM is not ready.
+ * @note   The unused bytes of the last word are padded with 0xFF.
+ */
+int32_t FLASH_WriterFlush(stc_flash_writer_t *pstcWriter)
+{
+    int32_t i32Ret;
+
+    if (pstcWriter == NULL) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (pstcWriter->u8WordLen == 0U) {
+        return LL_OK;
+    }
+
+    while (pstcWriter->u8WordLen < 4U) {
+        pstcWriter->au8Word[pstcWriter->u8WordLen++] = 0xFFU;
+    }
+    i32Ret = FLASH_WriterPrepare(pstcWriter, pstcWriter->u32Addr + 4UL);
+    if (LL_OK == i32Ret) {
+        i32Ret = FLASH_WriterProgram(pstcWriter->u32Addr, pstcWriter->au8Word, 4UL);
+    }
+    if (LL_OK == i32Ret) {
+        pstcWriter->u32Addr += 4UL;
+        pstcWriter->u8WordLen = 0U;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Start erasing the current sector of the background job.
+ * @param  u32Addr                      Sector address
+ * @retval None
+ * @note   Runs from RAM, the flash array is busy as soon as the dummy write lands.
+ */
+static __RAM_FUNC void FLASH_EraseKick(uint32_t u32Addr)
+{
+    WRITE_REG32(CM_EFM->FSCLR, EFM_FLAG_ALL);
+    MODIFY_REG32(CM_EFM->FWMC, EFM_FWMC_PEMOD, EFM_MD_ERASE_SECTOR);
+    m_stcEraseJob.u32KickCycle = DWT->CYCCNT;
+    RW_MEM32(u32Addr) = 0UL;
+}
+
+/**
+ * @brief  EFM operation end IRQ callback, finishes one sector and starts the next.
+ * @param  None
+ * @retval None
+ */
+static __RAM_FUNC void FLASH_EraseOptEnd_IrqCallback(void)
+{
+    uint32_t u32Sector = m_stcEraseJob.u32Addr;
+    int32_t i32Ret = LL_OK;
+
+    /* Only the end of a sector erase belongs to the job, mask anything else
+       and leave the flag to its owner (FLASH_EraseResume() unmasks again) */
+    if (READ_REG32_BIT(CM_EFM->FWMC, EFM_FWMC_PEMOD) != EFM_MD_ERASE_SECTOR) {
+        CLR_REG32_BIT(CM_EFM->FITE, EFM_INT_OPTEND);
+        return;
+    }
+
+    if (0UL != READ_REG32_BIT(CM_EFM->FSR, FLASH_ERASE_ERR_FLAG)) {
+        i32Ret = LL_ERR;
+    }
+    WRITE_REG32(CM_EFM->FSCLR, EFM_FLAG_ALL);
+
+    if (LL_OK == i32Ret) {
+        FLASH_StatsErase(u32Sector, IAP_CYCLE_TO_US(DWT->CYCCNT - m_stcEraseJob.u32KickCycle));
+        m_stcEraseJob.u32Addr = u32Sector + FLASH_SECTOR_SIZE;
+    }
+    if ((LL_OK == i32Ret) && (m_stcEraseJob.u32Addr < m_stcEraseJob.u32EndAddr)) {
+        if (m_stcEraseJob.u8Hold != 0U) {
+            /* A program burst is waiting, park until FLASH_EraseResume() */
+            MODIFY_REG32(CM_EFM->FWMC, EFM_FWMC_PEMOD, EFM_MD_READONLY);
+            CLR_REG32_BIT(CM_EFM->FITE, EFM_INT_OPTEND);
+            m_stcEraseJob.u8Paused = 1U;
+        } else {
+            FLASH_EraseKick(m_stcEraseJob.u32Addr);
+        }
+    } else {
+        /* Job finished or failed */
+        MODIFY_REG32(CM_EFM->FWMC, EFM_FWMC_PEMOD, EFM_MD_READONLY);
+        CLR_REG32_BIT(CM_EFM->FITE, EFM_INT_OPTEND);
+        NVIC_DisableIRQ(FLASH_ERASE_IRQn);
+        MODIFY_REG32(CM_EFM->FRMC, EFM_CACHE_ALL, m_stcEraseJob.u32Cache);
+        m_stcEraseJob.i32Status = i32Ret;
+    }
+
+    if (m_stcEraseJob.pfnCallback != NULL) {
+        m_stcEraseJob.pfnCallback(u32Sector, i32Ret);
+    }
+}
+
+/**
+ * @brief  Erase flash sectors in the background.
+ * @param  u32Addr                      Flash address
+ * @param  u32Size                      Size to erase (0: current address sector)
+ * @param  pfnCallback                  Per-sector completion callback, may be NULL
+ * @retval int32_t:
+ *           - LL_OK: Erase started
+ *           - LL_ERR_BUSY: A background erase is still running
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ * @note   Each sector is started from RAM and the next one is issued from the
+ *         EFM operation end interrupt. A streaming writer parks the job between
+ *         sectors while it programs, so erase and program never overlap. The
+ *         other erase and program functions wait for the job to finish.
+ */
+int32_t FLASH_EraseSectorAsync(uint32_t u32Addr, uint32_t u32Size, func_flash_erase_cb_t pfnCallback)
+{
+    stc_irq_signin_config_t stcIrqSignConfig;
+    uint32_t u32EndAddr;
+
+    if (m_stcEraseJob.i32Status == LL_ERR_BUSY) {
+        return LL_ERR_BUSY;
+    }
+    if (u32Addr >= (FLASH_BASE + FLASH_SIZE)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    u32Addr -= (u32Addr % FLASH_SECTOR_SIZE);
+    if (u32Size == 0U) {
+        u32Size = FLASH_SECTOR_SIZE;
+    }
+    u32EndAddr = u32Addr + u32Size;
+    if ((u32EndAddr % FLASH_SECTOR_SIZE) != 0UL) {
+        u32EndAddr += FLASH_SECTOR_SIZE - (u32EndAddr % FLASH_SECTOR_SIZE);
+    }
+    if (u32EndAddr > (FLASH_BASE + FLASH_SIZE)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    stcIrqSignConfig.enIntSrc = FLASH_ERASE_INT_SRC;
+    stcIrqSignConfig.enIRQn = FLASH_ERASE_IRQn;
+    stcIrqSignConfig.pfnCallback = &FLASH_EraseOptEnd_IrqCallback;
+    if (LL_OK != INTC_IrqSignIn(&stcIrqSignConfig)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_stcEraseJob.u32StartAddr = u32Addr;
+    m_stcEraseJob.u32EndAddr   = u32EndAddr;
+    m_stcEraseJob.u32Addr      = u32Addr;
+    m_stcEraseJob.pfnCallback  = pfnCallback;
+    m_stcEraseJob.u8Hold       = 0U;
+    m_stcEraseJob.u8Paused     = 0U;
+    m_stcEraseJob.i32Status    = LL_ERR_BUSY;
+    /* Cache stays off for the whole job, restored by the last interrupt */
+    m_stcEraseJob.u32Cache = READ_REG32_BIT(CM_EFM->FRMC, EFM_CACHE_ALL);
+    CLR_REG32_BIT(CM_EFM->FRMC, EFM_CACHE_ALL);
+
+    EFM_ClearStatus(EFM_FLAG_ALL);
+    EFM_IntCmd(EFM_INT_OPTEND, ENABLE);
+    NVIC_ClearPendingIRQ(FLASH_ERASE_IRQn);
+    NVIC_SetPriority(FLASH_ERASE_IRQn, DDL_IRQ_PRIO_DEFAULT);
+    NVIC_EnableIRQ(FLASH_ERASE_IRQn);
+
+    FLASH_EraseKick(u32Addr);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Get the state of the background erase.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK: No job running, the last one succeeded
+ *           - LL_ERR_BUSY: Erase in progress
+ *           - LL_ERR: The last job failed
+ */
+int32_t FLASH_GetEraseStatus(void)
+{
+    return m_stcEraseJob.i32Status;
+}
+
+/**
+ * @brief  Wait until the background erase job has finished.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK: No job running, the last one succeeded
+ *           - LL_ERR: The last job failed
+ *           - LL_ERR_TIMEOUT: A sector erase did not finish in time
+ * @note   Erasing or programming by other means than the streaming writer
+ *         must wait for this, the job and the EFM cannot be shared.
+ */
+int32_t FLASH_WaitEraseDone(void)
+{
+    uint32_t u32Last = m_stcEraseJob.u32Addr;
+    uint32_t u32Tick = SysTick_GetTick();
+
+    while (m_stcEraseJob.i32Status == LL_ERR_BUSY) {
+        if (m_stcEraseJob.u32Addr != u32Last) {
+            u32Last = m_stcEraseJob.u32Addr;
+            u32Tick = SysTick_GetTick();
+        } else if ((SysTick_GetTick() - u32Tick) > FLASH_ERASE_TIMEOUT_MS) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    return m_stcEraseJob.i32Status;
+}
+
+/**
+ * @brief  Wait until a sector of the background erase job is erased.
+ * @param  u32Addr                      Address in the sector
+ * @retval int32_t:
+ *           - LL_OK: Sector erased
+ *           - LL_ERR: Erase failed
+ *           - LL_ERR_TIMEOUT: Erase timeout
+ *           - LL_ERR_INVD_PARAM: The sector is not part of the last job, or a
+ *             writer has already taken it
+ */
+int32_t FLASH_WaitEraseSector(uint32_t u32Addr)
+{
+    uint32_t u32Sector = u32Addr - (u32Addr % FLASH_SECTOR_SIZE);
+    uint32_t u32Last;
+    uint32_t u32Tick;
+
+    if ((u32Sector < m_stcEraseJob.u32StartAddr) || (u32Sector >= m_stcEraseJob.u32EndAddr)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    u32Last = m_stcEraseJob.u32Addr;
+    u32Tick = SysTick_GetTick();
+    while ((m_stcEraseJob.i32Status == LL_ERR_BUSY) && (m_stcEraseJob.u32Addr <= u32Sector)) {
+        if (m_stcEraseJob.u32Addr != u32Last) {
+            u32Last = m_stcEraseJob.u32Addr;
+            u32Tick = SysTick_GetTick();
+        } else if ((SysTick_GetTick() - u32Tick) > FLASH_ERASE_TIMEOUT_MS) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    if (m_stcEraseJob.u32Addr > u32Sector) {
+        return LL_OK;
+    }
+    return m_stcEraseJob.i32Status;
+}
+
+#if (FLASH_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Measure the program speed of single and sequence program mode.
+ * @param  u32Addr                      Sector aligned address of a scratch sector
+ * @param  pu32SingleUs                 Time (us) to program 1KB in single program mode
+ * @param  pu32SeqUs                    Time (us) to program 1KB in sequence program mode
+ * @retval int32_t:
+ *           - LL_OK: Benchmark succeeded
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ *           - LL_ERR_NOT_RDY: EFM is not ready.
+ * @note   The sector at u32Addr is erased twice and left erased.
+ */
+int32_t FLASH_Benchmark(uint32_t u32Addr, uint32_t *pu32SingleUs, uint32_t *pu32SeqUs)
+{
+    static uint32_t au32Pattern[FLASH_BENCH_SIZE / 4U];
+    int32_t i32Ret;
+    uint32_t i;
+    uint32_t u32Cycle;
+
+    if ((pu32SingleUs == NULL) || (pu32SeqUs == NULL) || (LL_OK != FLASH_CheckAddrAlign(u32Addr)) ||
+        ((u32Addr + FLASH_SECTOR_SIZE) > (FLASH_BASE + FLASH_SIZE))) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (LL_ERR_TIMEOUT == FLASH_WaitEraseDone()) {
+        return LL_ERR_NOT_RDY;
+    }
+    for (i = 0UL; i < (FLASH_BENCH_SIZE / 4U); i++) {
+        au32Pattern[i] = i * 0x01010101UL;
+    }
+
+    /* Single program mode, executed from flash */
+    i32Ret = EFM_SectorErase(u32Addr);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+    u32Cycle = IAP_GetCycleCount();
+    i32Ret = EFM_Program(u32Addr, (uint8_t *)au32Pattern, FLASH_BENCH_SIZE);
+    *pu32SingleUs = IAP_CYCLE_TO_US(IAP_GetCycleCount() - u32Cycle);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    /* Sequence program mode, executed from RAM */
+    i32Ret = EFM_SectorErase(u32Addr);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+    u32Cycle = IAP_GetCycleCount();
+    i32Ret = EFM_SequenceProgram(u32Addr, (uint8_t *)au32Pattern, FLASH_BENCH_SIZE);
+    *pu32SeqUs = IAP_CYCLE_TO_US(IAP_GetCycleCount() - u32Cycle);
+    if (LL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    return EFM_SectorErase(u32Addr);
+}
+#endif /* FLASH_BENCH_ENABLE */
+
 /******************************************************************************
  * EOF (not truncated)
  *****************************************************************************/
@@ -23,10 +23,6 @@ extern "C"
  ******************************************************************************/
 #include "hc32_ll_efm.h"
 
-/*******************************************************************************
- * Global type definitions ('typedef')
- ******************************************************************************/
-
 /*******************************************************************************
  * Global pre-processor symbols/macros ('#define')
  ******************************************************************************/
@@ -36,11 +32,64 @@ extern "C"
 #define FLASH_SECTOR_SIZE               (EFM_SECTOR_SIZE)
 #define FLASH_SECTOR_NUM                (64U)
 
+/* Flash statistics record, alone in the last flash sector behind the application area */
+#define FLASH_STATS_ADDR                (IAP_APP_ADDR + IAP_APP_SIZE)
+#define FLASH_STATS_SLOT_SIZE           (0x200UL)
+#define FLASH_STATS_SLOT_NUM            (FLASH_SECTOR_SIZE / FLASH_STATS_SLOT_SIZE)
+#define FLASH_STATS_MAGIC               (0x46535441UL)
+
+/* Program speed benchmark On/Off */
+#ifndef FLASH_BENCH_ENABLE
+#define FLASH_BENCH_ENABLE              (DDL_OFF)
+#endif
+
 /* SRAM definitions */
 #define SRAM_SIZE                       (0x02F000UL)
 /* Vector table */
 #define VECT_TAB_STEP                   (0x400UL)
 
+/*******************************************************************************
+ * Global type definitions ('typedef')
+ ******************************************************************************/
+/**
+ * @brief Streaming flash writer.
+ * @note  Accepts pieces of any length at any alignment. Partial words are held
+ *        back until complete, whole words are programmed straight from the
+ *        caller's buffer and sectors are erased the first time they are reached.
+ */
+typedef struct {
+    uint32_t u32Addr;                   /*!< Next word address to be programmed */
+    uint32_t u32EraseAddr;              /*!< Sectors below this address are erased */
+    uint32_t u32Total;                  /*!< Bytes accepted since open */
+    uint8_t  au8Word[4];                /*!< Pending partial word */
+    uint8_t  u8WordLen;                 /*!< Number of valid bytes in au8Word */
+} stc_flash_writer_t;
+
+/**
+ * @brief Internal flash wear and timing statistics.
+ * @note  Stored in one of FLASH_STATS_SLOT_NUM slots at FLASH_STATS_ADDR, the
+ *        slot with the highest valid index is the newest. Times are in us,
+ *        program times are normalised to 1KB. Averages are rolling (1/8 weight).
+ */
+typedef struct {
+    uint32_t u32Magic;                          /*!< FLASH_STATS_MAGIC */
+    uint32_t au32EraseCnt[FLASH_SECTOR_NUM];    /*!< Erase count per sector */
+    uint32_t u32EraseMin;
+    uint32_t u32EraseMax;
+    uint32_t u32EraseAvg;
+    uint32_t u32ProgMin;
+    uint32_t u32ProgMax;
+    uint32_t u32ProgAvg;
+} stc_flash_stats_t;
+
+/**
+ * @brief Background erase per-sector completion callback.
+ * @param u32SectorAddr                 Start address of the sector just finished
+ * @param i32Result                     LL_OK or LL_ERR
+ * @note  Called from the EFM interrupt.
+ */
+typedef void (*func_flash_erase_cb_t)(uint32_t u32SectorAddr, int32_t i32Result);
+
 /*******************************************************************************
  * Global variable definitions ('extern')
  ******************************************************************************/
@@ -52,6 +101,23 @@ int32_t FLASH_CheckAddrAlign(uint32_t u32Addr);
 int32_t FLASH_EraseSector(uint32_t u32Addr, uint32_t u32Size);
 int32_t FLASH_WriteData(uint32_t u32Addr, uint8_t *pu8Buff, uint32_t u32Len);
 int32_t FLASH_ReadData(uint32_t u32Addr, uint8_t *pu8Buff, uint32_t u32Len);
+int32_t FLASH_VerifyData(uint32_t u32Addr, const uint8_t *pu8Buff, uint32_t u32Len);
+
+int32_t FLASH_WriterOpen(stc_flash_writer_t *pstcWriter, uint32_t u32Addr);
+int32_t FLASH_WriterAppend(stc_flash_writer_t *pstcWriter, const uint8_t *pu8Buff, uint32_t u32Len);
+int32_t FLASH_WriterFlush(stc_flash_writer_t *pstcWriter);
+
+void FLASH_StatsLoad(void);
+int32_t FLASH_StatsSave(void);
+const stc_flash_stats_t *FLASH_GetStats(void);
+
+int32_t FLASH_EraseSectorAsync(uint32_t u32Addr, uint32_t u32Size, func_flash_erase_cb_t pfnCallback);
+int32_t FLASH_GetEraseStatus(void);
+int32_t FLASH_WaitEraseDone(void);
+int32_t FLASH_WaitEraseSector(uint32_t u32Addr);
+#if (FLASH_BENCH_ENABLE == DDL_ON)
+int32_t FLASH_Benchmark(uint32_t u32Addr, uint32_t *pu32SingleUs, uint32_t *pu32SeqUs);
+#endif
 
 #ifdef __cplusplus
 }
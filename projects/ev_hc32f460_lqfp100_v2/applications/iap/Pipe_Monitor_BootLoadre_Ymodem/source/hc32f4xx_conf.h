@@ -57,7 +57,7 @@ extern "C"
 #define LL_CAN_ENABLE                               (DDL_OFF)
 #define LL_CLK_ENABLE                               (DDL_ON)
 #define LL_CMP_ENABLE                               (DDL_OFF)
-#define LL_CRC_ENABLE                               (DDL_OFF)
+#define LL_CRC_ENABLE                               (DDL_ON)
 #define LL_DBGC_ENABLE                              (DDL_OFF)
 #define LL_DCU_ENABLE                               (DDL_OFF)
 #define LL_DMA_ENABLE                               (DDL_ON)
@@ -118,7 +118,8 @@ extern "C"
 #define IAP_BOOT_SIZE                               (0x14000UL)
 /* APP configuration */
 #define IAP_APP_ADDR                                (EFM_BASE + IAP_BOOT_SIZE)
-#define IAP_APP_SIZE                                (FLASH_SIZE - IAP_BOOT_SIZE)
+/* The last sector holds the flash statistics (FLASH_STATS_ADDR) */
+#define IAP_APP_SIZE                                (FLASH_SIZE - IAP_BOOT_SIZE - EFM_SECTOR_SIZE)
 
 #define APP_EXIST_FLAG_ADDR                         (EFM_BASE + IAP_BOOT_SIZE - 4U)
 #define APP_UPGRADE_FLAG_ADDR                       (EFM_BASE + IAP_BOOT_SIZE - 8U)
@@ -0,0 +1,613 @@
+/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\source\image.c
+ * @brief This file provides firmware functions to stage application images in
+ *        the W25Q128 and install them into the internal flash.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-03-12       Joe             First version
+ @endverbatim
+
+ */
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+#include "image.h"
+#include "main.h"
+#include "W25Q128.h"
+#include "string.h"
+
+/*******************************************************************************
+ * Local type definitions ('typedef')
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Local pre-processor symbols/macros ('#define')
+ ******************************************************************************/
+#define IMAGE_CRC_INIT                  (0xFFFFFFFFUL)
+/* Bytes of stc_image_manifest_t covered by u32HdrCrc */
+#define IMAGE_HDR_CRC_LEN               (16UL)
+
+/*******************************************************************************
+ * Global variable definitions (declared in header file with 'extern')
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Local function prototypes ('static')
+ ******************************************************************************/
+static uint32_t IMAGE_Crc32(uint32_t u32Crc, const uint8_t *pu8Buff, uint32_t u32Len);
+static int32_t IMAGE_SlotCrc(uint32_t u32Addr, uint32_t u32Size, uint32_t *pu32Crc);
+static int32_t IMAGE_CopyToFlash(uint32_t u32SrcAddr, uint32_t u32DestAddr, uint32_t u32Size, uint32_t u32Crc);
+static int32_t IMAGE_WriteManifest(uint32_t u32Addr, uint32_t u32Size, uint32_t u32Version, uint32_t u32Crc,
+                                   uint32_t u32Pending, uint32_t u32Confirmed);
+static int32_t IMAGE_InstallSlot(uint32_t u32SlotAddr, const stc_image_manifest_t *pstcManifest);
+static int32_t IMAGE_SaveGolden(const stc_image_manifest_t *pstcStage);
+
+/*******************************************************************************
+ * Local variable definitions ('static')
+ ******************************************************************************/
+/* CRC32 (IEEE 802.3, reflected 0xEDB88320) lookup table */
+static const uint32_t m_au32Crc32Table[256] = {
+    0x00000000UL, 0x77073096UL, 0xEE0E612CUL, 0x990951BAUL, 0x076DC419UL, 0x706AF48FUL,
+    0xE963A535UL, 0x9E6495A3UL, 0x0EDB8832UL, 0x79DCB8A4UL, 0xE0D5E91EUL, 0x97D2D988UL,
+    0x09B64C2BUL, 0x7EB17CBDUL, 0xE7B82D07UL, 0x90BF1D91UL, 0x1DB71064UL, 0x6AB020F2UL,
+    0xF3B97148UL, 0x84BE41DEUL, 0x1ADAD47DUL, 0x6DDDE4EBUL, 0xF4D4B551UL, 0x83D385C7UL,
+    0x136C9856UL, 0x646BA8C0UL, 0xFD62F97AUL, 0x8A65C9ECUL, 0x14015C4FUL, 0x63066CD9UL,
+    0xFA0F3D63UL, 0x8D080DF5UL, 0x3B6E20C8UL, 0x4C69105EUL, 0xD56041E4UL, 0xA2677172UL,
+    0x3C03E4D1UL, 0x4B04D447UL, 0xD20D85FDUL, 0xA50AB56BUL, 0x35B5A8FAUL, 0x42B2986CUL,
+    0xDBBBC9D6UL, 0xACBCF940UL, 0x32D86CE3UL, 0x45DF5C75UL, 0xDCD60DCFUL, 0xABD13D59UL,
+    0x26D930ACUL, 0x51DE003AUL, 0xC8D75180UL, 0xBFD06116UL, 0x21B4F4B5UL, 0x56B3C423UL,
+    0xCFBA9599UL, 0xB8BDA50FUL, 0x2802B89EUL, 0x5F058808UL, 0xC60CD9B2UL, 0xB10BE924UL,
+    0x2F6F7C87UL, 0x58684C11UL, 0xC1611DABUL, 0xB6662D3DUL, 0x76DC4190UL, 0x01DB7106UL,
+    0x98D220BCUL, 0xEFD5102AUL, 0x71B18589UL, 0x06B6B51FUL, 0x9FBFE4A5UL, 0xE8B8D433UL,
+    0x7807C9A2UL, 0x0F00F934UL, 0x9609A88EUL, 0xE10E9818UL, 0x7F6A0DBBUL, 0x086D3D2DUL,
+    0x91646C97UL, 0xE6635C01UL, 0x6B6B51F4UL, 0x1C6C6162UL, 0x856530D8UL, 0xF262004EUL,
+    0x6C0695EDUL, 0x1B01A57BUL, 0x8208F4C1UL, 0xF50FC457UL, 0x65B0D9C6UL, 0x12B7E950UL,
+    0x8BBEB8EAUL, 0xFCB9887CUL, 0x62DD1DDFUL, 0x15DA2D49UL, 0x8CD37CF3UL, 0xFBD44C65UL,
+    0x4DB26158UL, 0x3AB551CEUL, 0xA3BC0074UL, 0xD4BB30E2UL, 0x4ADFA541UL, 0x3DD895D7UL,
+    0xA4D1C46DUL, 0xD3D6F4FBUL, 0x4369E96AUL, 0x346ED9FCUL, 0xAD678846UL, 0xDA60B8D0UL,
+    0x44042D73UL, 0x33031DE5UL, 0xAA0A4C5FUL, 0xDD0D7CC9UL, 0x5005713CUL, 0x270241AAUL,
+    0xBE0B1010UL, 0xC90C2086UL, 0x5768B525UL, 0x206F85B3UL, 0xB966D409UL, 0xCE61E49FUL,
+    0x5EDEF90EUL, 0x29D9C998UL, 0xB0D09822UL, 0xC7D7A8B4UL, 0x59B33D17UL, 0x2EB40D81UL,
+    0xB7BD5C3BUL, 0xC0BA6CADUL, 0xEDB88320UL, 0x9ABFB3B6UL, 0x03B6E20CUL, 0x74B1D29AUL,
+    0xEAD54739UL, 0x9DD277AFUL, 0x04DB2615UL, 0x73DC1683UL, 0xE3630B12UL, 0x94643B84UL,
+    0x0D6D6A3EUL, 0x7A6A5AA8UL, 0xE40ECF0BUL, 0x9309FF9DUL, 0x0A00AE27UL, 0x7D079EB1UL,
+    0xF00F9344UL, 0x8708A3D2UL, 0x1E01F268UL, 0x6906C2FEUL, 0xF762575DUL, 0x806567CBUL,
+    0x196C3671UL, 0x6E6B06E7UL, 0xFED41B76UL, 0x89D32BE0UL, 0x10DA7A5AUL, 0x67DD4ACCUL,
+    0xF9B9DF6FUL, 0x8EBEEFF9UL, 0x17B7BE43UL, 0x60B08ED5UL, 0xD6D6A3E8UL, 0xA1D1937EUL,
+    0x38D8C2C4UL, 0x4FDFF252UL, 0xD1BB67F1UL, 0xA6BC5767UL, 0x3FB506DDUL, 0x48B2364BUL,
+    0xD80D2BDAUL, 0xAF0A1B4CUL, 0x36034AF6UL, 0x41047A60UL, 0xDF60EFC3UL, 0xA867DF55UL,
+    0x316E8EEFUL, 0x4669BE79UL, 0xCB61B38CUL, 0xBC66831AUL, 0x256FD2A0UL, 0x5268E236UL,
+    0xCC0C7795UL, 0xBB0B4703UL, 0x220216B9UL, 0x5505262FUL, 0xC5BA3BBEUL, 0xB2BD0B28UL,
+    0x2BB45A92UL, 0x5CB36A04UL, 0xC2D7FFA7UL, 0xB5D0CF31UL, 0x2CD99E8BUL, 0x5BDEAE1DUL,
+    0x9B64C2B0UL, 0xEC63F226UL, 0x756AA39CUL, 0x026D930AUL, 0x9C0906A9UL, 0xEB0E363FUL,
+    0x72076785UL, 0x05005713UL, 0x95BF4A82UL, 0xE2B87A14UL, 0x7BB12BAEUL, 0x0CB61B38UL,
+    0x92D28E9BUL, 0xE5D5BE0DUL, 0x7CDCEFB7UL, 0x0BDBDF21UL, 0x86D3D2D4UL, 0xF1D4E242UL,
+    0x68DDB3F8UL, 0x1FDA836EUL, 0x81BE16CDUL, 0xF6B9265BUL, 0x6FB077E1UL, 0x18B74777UL,
+    0x88085AE6UL, 0xFF0F6A70UL, 0x66063BCAUL, 0x11010B5CUL, 0x8F659EFFUL, 0xF862AE69UL,
+    0x616BFFD3UL, 0x166CCF45UL, 0xA00AE278UL, 0xD70DD2EEUL, 0x4E048354UL, 0x3903B3C2UL,
+    0xA7672661UL, 0xD06016F7UL, 0x4969474DUL, 0x3E6E77DBUL, 0xAED16A4AUL, 0xD9D65ADCUL,
+    0x40DF0B66UL, 0x37D83BF0UL, 0xA9BCAE53UL, 0xDEBB9EC5UL, 0x47B2CF7FUL, 0x30B5FFE9UL,
+    0xBDBDF21CUL, 0xCABAC28AUL, 0x53B39330UL, 0x24B4A3A6UL, 0xBAD03605UL, 0xCDD70693UL,
+    0x54DE5729UL, 0x23D967BFUL, 0xB3667A2EUL, 0xC4614AB8UL, 0x5D681B02UL, 0x2A6F2B94UL,
+    0xB40BBE37UL, 0xC30C8EA1UL, 0x5A05DF1BUL, 0x2D02EF8DUL
+};
+
+/* Ping-pong buffers, one is filled by SPI DMA while the other is programmed */
+static uint32_t m_au32CopyBuf[2][IMAGE_COPY_CHUNK / 4U];
+
+/*******************************************************************************
+ * Function implementation - global ('extern') and local ('static')
+ ******************************************************************************/
+/**
+ * @brief  Update a running CRC32.
+ * @param  u32Crc                       Running value, IMAGE_CRC_INIT to start
+ * @param  pu8Buff                      Pointer to the data
+ * @param  u32Len                       Data length
+ * @retval Running value, the CRC32 is its complement
+ * @note   The CRC unit is not used here, FLASH_VerifyData() restarts it for
+ *         every programmed block.
+ */
+static uint32_t IMAGE_Crc32(uint32_t u32Crc, const uint8_t *pu8Buff, uint32_t u32Len)
+{
+    while (u32Len-- != 0UL) {
+        u32Crc = m_au32Crc32Table[(u32Crc ^ *pu8Buff++) & 0xFFUL] ^ (u32Crc >> 8U);
+    }
+
+    return u32Crc;
+}
+
+/**
+ * @brief  CRC32 of a W25Q128 range.
+ * @param  u32Addr                      W25Q128 address
+ * @param  u32Size                      Size in bytes
+ * @param  pu32Crc                      Pointer to the CRC32
+ * @retval int32_t:
+ *           - LL_OK: CRC calculated
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ * @note   The next chunk is read by DMA while the current one is summed.
+ */
+static int32_t IMAGE_SlotCrc(uint32_t u32Addr, uint32_t u32Size, uint32_t *pu32Crc)
+{
+    uint32_t u32Crc = IMAGE_CRC_INIT;
+    uint32_t u32Done = 0UL;
+    uint32_t u32Len = (u32Size > IMAGE_COPY_CHUNK) ? IMAGE_COPY_CHUNK : u32Size;
+    uint32_t u32NextLen = 0UL;
+    uint8_t u8Buf = 0U;
+    int32_t i32Ret;
+
+    i32Ret = BSP_W25QXX_ReadStart(u32Addr, (uint8_t *)m_au32CopyBuf[0U], u32Len);
+    while ((i32Ret == LL_OK) && (u32Done < u32Size)) {
+        i32Ret = BSP_W25QXX_ReadWait();
+        if ((i32Ret == LL_OK) && ((u32Done + u32Len) < u32Size)) {
+            u32NextLen = u32Size - (u32Done + u32Len);
+            u32NextLen = (u32NextLen > IMAGE_COPY_CHUNK) ? IMAGE_COPY_CHUNK : u32NextLen;
+            i32Ret = BSP_W25QXX_ReadStart(u32Addr + u32Done + u32Len, (uint8_t *)m_au32CopyBuf[u8Buf ^ 1U],
+                                          u32NextLen);
+        }
+        if (i32Ret == LL_OK) {
+            u32Crc = IMAGE_Crc32(u32Crc, (const uint8_t *)m_au32CopyBuf[u8Buf], u32Len);
+            u32Done += u32Len;
+            u32Len = u32NextLen;
+            u8Buf ^= 1U;
+        }
+    }
+    (void)BSP_W25QXX_ReadWait();
+    *pu32Crc = ~u32Crc;
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Copy an image from the W25Q128 into the internal flash.
+ * @param  u32SrcAddr                   W25Q128 address of the image
+ * @param  u32DestAddr                  Sector aligned flash address
+ * @param  u32Size                      Image size
+ * @param  u32Crc                       Expected CRC32 of the image
+ * @retval int32_t:
+ *           - LL_OK: Image programmed and verified
+ *           - LL_ERR: Data read back from the W25Q128 does not match u32Crc
+ *           - Other: Error from the W25Q128 or the flash writer
+ * @note   Destination sectors are erased in the background. Chunk n+1 is
+ *         clocked in by SPI DMA while chunk n is programmed, so the copy runs
+ *         at the EFM program rate.
+ */
+static int32_t IMAGE_CopyToFlash(uint32_t u32SrcAddr, uint32_t u32DestAddr, uint32_t u32Size, uint32_t u32Crc)
+{
+    stc_flash_writer_t stcWriter;
+    uint32_t u32Calc = IMAGE_CRC_INIT;
+    uint32_t u32Done = 0UL;
+    uint32_t u32Len = (u32Size > IMAGE_COPY_CHUNK) ? IMAGE_COPY_CHUNK : u32Size;
+    uint32_t u32NextLen = 0UL;
+    uint8_t u8Buf = 0U;
+    int32_t i32Ret;
+
+    i32Ret = FLASH_EraseSectorAsync(u32DestAddr, u32Size, NULL);
+    if (i32Ret == LL_OK) {
+        i32Ret = FLASH_WriterOpen(&stcWriter, u32DestAddr);
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_ReadStart(u32SrcAddr, (uint8_t *)m_au32CopyBuf[0U], u32Len);
+    }
+    while ((i32Ret == LL_OK) && (u32Done < u32Size)) {
+        i32Ret = BSP_W25QXX_ReadWait();
+        if ((i32Ret == LL_OK) && ((u32Done + u32Len) < u32Size)) {
+            u32NextLen = u32Size - (u32Done + u32Len);
+            u32NextLen = (u32NextLen > IMAGE_COPY_CHUNK) ? IMAGE_COPY_CHUNK : u32NextLen;
+            i32Ret = BSP_W25QXX_ReadStart(u32SrcAddr + u32Done + u32Len, (uint8_t *)m_au32CopyBuf[u8Buf ^ 1U],
+                                          u32NextLen);
+        }
+        if (i32Ret == LL_OK) {
+            u32Calc = IMAGE_Crc32(u32Calc, (const uint8_t *)m_au32CopyBuf[u8Buf], u32Len);
+            i32Ret = FLASH_WriterAppend(&stcWriter, (const uint8_t *)m_au32CopyBuf[u8Buf], u32Len);
+        }
+        if (i32Ret == LL_OK) {
+            u32Done += u32Len;
+            u32Len = u32NextLen;
+            u8Buf ^= 1U;
+        }
+        func_WatchDog_Refresh();
+    }
+    (void)BSP_W25QXX_ReadWait();
+    if (i32Ret == LL_OK) {
+        i32Ret = FLASH_WriterFlush(&stcWriter);
+    }
+    /* Never leave the background erase running under the caller */
+    (void)FLASH_WaitEraseDone();
+    if ((i32Ret == LL_OK) && (~u32Calc != u32Crc)) {
+        i32Ret = LL_ERR;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Write a manifest into an erased manifest sector.
+ * @param  u32Addr                      W25Q128 address of the manifest
+ * @param  u32Size                      Image size
+ * @param  u32Version                   Image version
+ * @param  u32Crc                       CRC32 of the image
+ * @param  u32Pending                   IMAGE_PENDING or IMAGE_INSTALLED
+ * @param  u32Confirmed                 IMAGE_UNCONFIRMED or IMAGE_CONFIRMED
+ * @retval int32_t:
+ *           - LL_OK: Manifest written
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ */
+static int32_t IMAGE_WriteManifest(uint32_t u32Addr, uint32_t u32Size, uint32_t u32Version, uint32_t u32Crc,
+                                   uint32_t u32Pending, uint32_t u32Confirmed)
+{
+    stc_image_manifest_t stcManifest;
+
+    stcManifest.u32Magic     = IMAGE_MANIFEST_MAGIC;
+    stcManifest.u32Size      = u32Size;
+    stcManifest.u32Version   = u32Version;
+    stcManifest.u32Crc       = u32Crc;
+    stcManifest.u32HdrCrc    = ~IMAGE_Crc32(IMAGE_CRC_INIT, (const uint8_t *)&stcManifest, IMAGE_HDR_CRC_LEN);
+    stcManifest.u32Pending   = u32Pending;
+    stcManifest.u32Confirmed = u32Confirmed;
+
+    return BSP_W25QXX_Write(u32Addr, (const uint8_t *)&stcManifest, sizeof(stcManifest));
+}
+
+/**
+ * @brief  Check a slot against its manifest and copy it into the application area.
+ * @param  u32SlotAddr                  W25Q128 address of the slot
+ * @param  pstcManifest                 Pointer to the manifest of the slot
+ * @retval int32_t:
+ *           - LL_OK: Image installed
+ *           - LL_ERR_INVD_PARAM: The slot does not match its manifest, the
+ *                                application area is untouched
+ *           - Other: The copy failed, the application flag stays cleared
+ * @note   The boot state is reset, so the installed image starts a fresh
+ *         trial whatever the previous application confirmed.
+ */
+static int32_t IMAGE_InstallSlot(uint32_t u32SlotAddr, const stc_image_manifest_t *pstcManifest)
+{
+    uint32_t u32Crc;
+    uint32_t u32Flag;
+    int32_t i32Ret;
+
+    if (pstcManifest->u32Size > IAP_APP_SIZE) {
+        return LL_ERR_INVD_PARAM;
+    }
+    i32Ret = IMAGE_SlotCrc(u32SlotAddr, pstcManifest->u32Size, &u32Crc);
+    if ((i32Ret == LL_OK) && (u32Crc != pstcManifest->u32Crc)) {
+        i32Ret = LL_ERR_INVD_PARAM;
+    }
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+
+    /* A confirm left by the old application must not count for the new one */
+    IMAGE_BOOT_STATE->u32Confirm     = 0UL;
+    IMAGE_BOOT_STATE->u32Attempts    = 0UL;
+    IMAGE_BOOT_STATE->u32AttemptsInv = 0xFFFFFFFFUL;
+    IMAGE_BOOT_STATE->u32Magic       = IMAGE_BOOT_MAGIC;
+
+    (void)FLASH_EraseSector(APP_EXIST_FLAG_ADDR, 0U);
+    i32Ret = IMAGE_CopyToFlash(u32SlotAddr, IAP_APP_ADDR, pstcManifest->u32Size, pstcManifest->u32Crc);
+    if (i32Ret == LL_OK) {
+        (void)FLASH_StatsSave();
+        u32Flag = APP_EXIST_FLAG;
+        i32Ret = FLASH_WriteData(APP_EXIST_FLAG_ADDR, (uint8_t *)&u32Flag, 4U);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Copy an image into the golden slot.
+ * @param  pstcStage                    Manifest of the staged image to copy,
+ *                                      NULL to copy the running application.
+ * @retval int32_t:
+ *           - LL_OK: Golden image written and verified
+ *           - LL_ERR: Source and golden slot do not match
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ * @note   The size of the running application is taken up to its last
+ *         programmed word. The golden manifest is erased first and written
+ *         last, an interrupted copy leaves no golden image.
+ */
+static int32_t IMAGE_SaveGolden(const stc_image_manifest_t *pstcStage)
+{
+    const uint8_t *pu8Src;
+    uint32_t u32Size;
+    uint32_t u32Done = 0UL;
+    uint32_t u32Len;
+    uint32_t u32Crc = IMAGE_CRC_INIT;
+    uint32_t u32Check;
+    int32_t i32Ret;
+
+    if (pstcStage != NULL) {
+        u32Size = pstcStage->u32Size;
+    } else {
+        u32Size = IAP_APP_SIZE;
+        while ((u32Size != 0UL) && (*(__IO uint32_t *)(IAP_APP_ADDR + u32Size - 4UL) == 0xFFFFFFFFUL)) {
+            u32Size -= 4UL;
+        }
+        if (u32Size == 0UL) {
+            return LL_ERR;
+        }
+    }
+
+    i32Ret = BSP_W25QXX_EraseSector(IMAGE_GOLDEN_MANIFEST_ADDR);
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_EraseRange(IMAGE_GOLDEN_ADDR, u32Size);
+    }
+    while ((i32Ret == LL_OK) && (u32Done < u32Size)) {
+        u32Len = ((u32Size - u32Done) > IMAGE_COPY_CHUNK) ? IMAGE_COPY_CHUNK : (u32Size - u32Done);
+        if (pstcStage != NULL) {
+            pu8Src = (const uint8_t *)m_au32CopyBuf[0U];
+            i32Ret = BSP_W25QXX_Read(IMAGE_STAGE_ADDR + u32Done, (uint8_t *)m_au32CopyBuf[0U], u32Len);
+        } else {
+            pu8Src = (const uint8_t *)(IAP_APP_ADDR + u32Done);
+        }
+        if (i32Ret == LL_OK) {
+            u32Crc = IMAGE_Crc32(u32Crc, pu8Src, u32Len);
+            i32Ret = BSP_W25QXX_Write(IMAGE_GOLDEN_ADDR + u32Done, pu8Src, u32Len);
+        }
+        u32Done += u32Len;
+        func_WatchDog_Refresh();
+    }
+    u32Crc = ~u32Crc;
+    if ((i32Ret == LL_OK) && (pstcStage != NULL) && (u32Crc != pstcStage->u32Crc)) {
+        i32Ret = LL_ERR;
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = IMAGE_SlotCrc(IMAGE_GOLDEN_ADDR, u32Size, &u32Check);
+        if ((i32Ret == LL_OK) && (u32Check != u32Crc)) {
+            i32Ret = LL_ERR;
+        }
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = IMAGE_WriteManifest(IMAGE_GOLDEN_MANIFEST_ADDR, u32Size,
+                                     (pstcStage != NULL) ? pstcStage->u32Version : 0UL, u32Crc,
+                                     IMAGE_INSTALLED, IMAGE_CONFIRMED);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Start staging an image.
+ * @param  pstcStage                    Pointer to the staging writer
+ * @param  u32Size                      Image size
+ * @param  u32Version                   Image version, 0 if unknown
+ * @retval int32_t:
+ *           - LL_OK: Slot erase started
+ *           - LL_ERR_INVD_PARAM: The image does not fit the slot or the app area
+ *           - LL_ERR_BUSY: A W25Q range erase is still running
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ * @note   The manifest is erased first, a partly staged image is never valid.
+ */
+int32_t IMAGE_StageOpen(stc_image_stage_t *pstcStage, uint32_t u32Size, uint32_t u32Version)
+{
+    int32_t i32Ret;
+
+    if ((pstcStage == NULL) || (u32Size == 0UL) || (u32Size > IMAGE_SLOT_SIZE) || (u32Size > IAP_APP_SIZE)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    i32Ret = BSP_W25QXX_EraseSector(IMAGE_STAGE_MANIFEST_ADDR);
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_EraseRangeAsync(IMAGE_STAGE_ADDR, u32Size);
+    }
+    pstcStage->u32Size    = u32Size;
+    pstcStage->u32Version = u32Version;
+    pstcStage->u32Offset  = 0UL;
+    pstcStage->u32Crc     = IMAGE_CRC_INIT;
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Append data to the staged image.
+ * @param  pstcStage                    Pointer to the staging writer
+ * @param  pu8Buff                      Pointer to the data
+ * @param  u32Len                       Data length, any size
+ * @retval int32_t:
+ *           - LL_OK: Data staged
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid or the data runs
+ *                                past the announced size.
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ * @note   The first call waits for the slot erase started by IMAGE_StageOpen().
+ */
+int32_t IMAGE_StageAppend(stc_image_stage_t *pstcStage, const uint8_t *pu8Buff, uint32_t u32Len)
+{
+    int32_t i32Ret;
+
+    if ((pstcStage == NULL) || (pu8Buff == NULL) || (u32Len > (pstcStage->u32Size - pstcStage->u32Offset))) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (u32Len == 0UL) {
+        return LL_OK;
+    }
+
+    do {
+        i32Ret = BSP_W25QXX_EraseRangePoll();
+    } while (i32Ret == LL_ERR_BUSY);
+    if (i32Ret == LL_OK) {
+        i32Ret = BSP_W25QXX_Write(IMAGE_STAGE_ADDR + pstcStage->u32Offset, pu8Buff, u32Len);
+    }
+    if (i32Ret == LL_OK) {
+        pstcStage->u32Crc = IMAGE_Crc32(pstcStage->u32Crc, pu8Buff, u32Len);
+        pstcStage->u32Offset += u32Len;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Finish staging, write the manifest and mark the image pending.
+ * @param  pstcStage                    Pointer to the staging writer
+ * @retval int32_t:
+ *           - LL_OK: Image ready for IMAGE_InstallPending()
+ *           - LL_ERR: The staged data is incomplete or reads back wrong
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ */
+int32_t IMAGE_StageClose(stc_image_stage_t *pstcStage)
+{
+    uint32_t u32Crc;
+    int32_t i32Ret;
+
+    if (pstcStage == NULL) {
+        return LL_ERR_INVD_PARAM;
+    }
+    if (pstcStage->u32Offset != pstcStage->u32Size) {
+        return LL_ERR;
+    }
+
+    /* Check what actually landed in the slot before publishing it */
+    i32Ret = IMAGE_SlotCrc(IMAGE_STAGE_ADDR, pstcStage->u32Size, &u32Crc);
+    if ((i32Ret == LL_OK) && (u32Crc != ~pstcStage->u32Crc)) {
+        i32Ret = LL_ERR;
+    }
+    if (i32Ret == LL_OK) {
+        i32Ret = IMAGE_WriteManifest(IMAGE_STAGE_MANIFEST_ADDR, pstcStage->u32Size, pstcStage->u32Version, u32Crc,
+                                     IMAGE_PENDING, IMAGE_UNCONFIRMED);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Read and check a manifest.
+ * @param  u32Addr                      W25Q128 address of the manifest
+ * @param  pstcManifest                 Pointer to the manifest
+ * @retval int32_t:
+ *           - LL_OK: Manifest valid
+ *           - LL_ERR: No valid manifest at u32Addr
+ *           - LL_ERR_INVD_PARAM: The parameters is invalid.
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ */
+int32_t IMAGE_ReadManifest(uint32_t u32Addr, stc_image_manifest_t *pstcManifest)
+{
+    int32_t i32Ret;
+
+    if (pstcManifest == NULL) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    i32Ret = BSP_W25QXX_Read(u32Addr, (uint8_t *)pstcManifest, sizeof(stc_image_manifest_t));
+    if ((i32Ret == LL_OK) &&
+        ((pstcManifest->u32Magic != IMAGE_MANIFEST_MAGIC) || (pstcManifest->u32Size == 0UL) ||
+         (pstcManifest->u32Size > IMAGE_SLOT_SIZE) ||
+         (pstcManifest->u32HdrCrc != ~IMAGE_Crc32(IMAGE_CRC_INIT, (const uint8_t *)pstcManifest, IMAGE_HDR_CRC_LEN)))) {
+        i32Ret = LL_ERR;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Install the staged image into the application area.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK: Image installed
+ *           - LL_ERR_NOT_RDY: No image pending
+ *           - LL_ERR: The staged image is corrupt (discarded) or the copy failed
+ *           - LL_ERR_TIMEOUT: SPI timeout or W25QXX timeout.
+ * @note   The staged image is checked against its manifest before the
+ *         application area is touched. If the copy fails the image stays
+ *         pending and is installed again at the next boot.
+ */
+int32_t IMAGE_InstallPending(void)
+{
+    stc_image_manifest_t stcManifest;
+    uint32_t u32Flag;
+    int32_t i32Ret;
+
+    if ((IMAGE_ReadManifest(IMAGE_STAGE_MANIFEST_ADDR, &stcManifest) != LL_OK) ||
+        (stcManifest.u32Pending != IMAGE_PENDING)) {
+        return LL_ERR_NOT_RDY;
+    }
+
+    i32Ret = IMAGE_InstallSlot(IMAGE_STAGE_ADDR, &stcManifest);
+    if (i32Ret == LL_ERR_INVD_PARAM) {
+        (void)BSP_W25QXX_EraseSector(IMAGE_STAGE_MANIFEST_ADDR);
+        i32Ret = LL_ERR;
+    }
+    if (i32Ret == LL_OK) {
+        u32Flag = IMAGE_INSTALLED;
+        i32Ret = BSP_W25QXX_Write(IMAGE_STAGE_MANIFEST_ADDR + offsetof(stc_image_manifest_t, u32Pending),
+                                  (const uint8_t *)&u32Flag, 4U);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Boot attempt accounting and rollback, call right before jumping
+ *         to the application.
+ * @param  None
+ * @retval int32_t:
+ *           - LL_OK: Nothing to do or the action below succeeded
+ *           - LL_ERR_NOT_RDY: Rollback needed but there is no golden image
+ *           - Other: Error from the W25Q128 or the flash writer
+ * @note   - Application area incomplete: restore the golden image.
+ *         - Installed image not yet confirmed: a confirmed start promotes
+ *           it to the golden slot, IMAGE_BOOT_ATTEMPT_MAX unconfirmed boots
+ *           restore the golden image and drop the staged one, otherwise the
+ *           attempt is counted.
+ *         - No golden image yet: the running application becomes golden.
+ */
+int32_t IMAGE_BootCheck(void)
+{
+    stc_image_boot_state_t *pstcState = IMAGE_BOOT_STATE;
+    stc_image_manifest_t stcStage;
+    stc_image_manifest_t stcGolden;
+    uint8_t u8Golden;
+    uint8_t u8Trial;
+    uint32_t u32Flag;
+    int32_t i32Ret = LL_OK;
+
+    if ((pstcState->u32Magic != IMAGE_BOOT_MAGIC) || (pstcState->u32AttemptsInv != ~pstcState->u32Attempts)) {
+        pstcState->u32Attempts = 0UL;
+        pstcState->u32Confirm  = 0UL;
+    }
+    u8Golden = (IMAGE_ReadManifest(IMAGE_GOLDEN_MANIFEST_ADDR, &stcGolden) == LL_OK) ? 1U : 0U;
+    u8Trial = ((IMAGE_ReadManifest(IMAGE_STAGE_MANIFEST_ADDR, &stcStage) == LL_OK) &&
+               (stcStage.u32Pending == IMAGE_INSTALLED) && (stcStage.u32Confirmed == IMAGE_UNCONFIRMED)) ? 1U : 0U;
+
+    if (APP_EXIST_FLAG != *(__IO uint32_t *)APP_EXIST_FLAG_ADDR) {
+        /* An install was cut short */
+        i32Ret = (u8Golden != 0U) ? IMAGE_InstallSlot(IMAGE_GOLDEN_ADDR, &stcGolden) : LL_ERR_NOT_RDY;
+        pstcState->u32Attempts = 0UL;
+    } else if (u8Trial != 0U) {
+        if (pstcState->u32Confirm == IMAGE_BOOT_CONFIRM) {
+            i32Ret = IMAGE_SaveGolden(&stcStage);
+            if (i32Ret == LL_OK) {
+                u32Flag = IMAGE_CONFIRMED;
+                i32Ret = BSP_W25QXX_Write(IMAGE_STAGE_MANIFEST_ADDR + offsetof(stc_image_manifest_t, u32Confirmed),
+                                          (const uint8_t *)&u32Flag, 4U);
+            }
+            pstcState->u32Attempts = 0UL;
+        } else if (pstcState->u32Attempts >= IMAGE_BOOT_ATTEMPT_MAX) {
+            i32Ret = (u8Golden != 0U) ? IMAGE_InstallSlot(IMAGE_GOLDEN_ADDR, &stcGolden) : LL_ERR_NOT_RDY;
+            if (i32Ret == LL_OK) {
+                /* Never install the broken image again */
+                (void)BSP_W25QXX_EraseSector(IMAGE_STAGE_MANIFEST_ADDR);
+                pstcState->u32Attempts = 0UL;
+            }
+        } else {
+            pstcState->u32Attempts++;
+        }
+    } else {
+        pstcState->u32Attempts = 0UL;
+        if (u8Golden == 0U) {
+            i32Ret = IMAGE_SaveGolden(NULL);
+        }
+    }
+
+    pstcState->u32Confirm     = 0UL;
+    pstcState->u32AttemptsInv = ~pstcState->u32Attempts;
+    pstcState->u32Magic       = IMAGE_BOOT_MAGIC;
+
+    return i32Ret;
+}
+
+/*******************************************************************************
+ * EOF (not truncated)
+ ******************************************************************************/
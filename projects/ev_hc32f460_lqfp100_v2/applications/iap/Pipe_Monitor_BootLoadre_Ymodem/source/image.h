@@ -0,0 +1,131 @@
+/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\source\image.h
+ * @brief This file contains all the functions prototypes of the application
+ *        image staging and installer.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-03-12       Joe             First version
+ @endverbatim
+
+ */
+#ifndef __IMAGE_H__
+#define __IMAGE_H__
+
+/* C binding of definitions if building with C++ compiler */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+#include "hc32_ll.h"
+
+/*******************************************************************************
+ * Global pre-processor symbols/macros ('#define')
+ ******************************************************************************/
+/*
+ * W25Q128 image area, shared with the application:
+ *   0xF00000  manifest block (64KB, one 4KB sector per manifest)
+ *   0xF10000  staging slot (IMAGE_SLOT_SIZE)
+ *   0xF80000  golden slot, last image that reported a healthy start
+ * The last 64KB block stays free for W25QXX_BENCH_ADDR.
+ */
+#define IMAGE_MANIFEST_BLOCK_ADDR       (0xF00000UL)
+#define IMAGE_STAGE_MANIFEST_ADDR       (IMAGE_MANIFEST_BLOCK_ADDR)
+#define IMAGE_GOLDEN_MANIFEST_ADDR      (IMAGE_MANIFEST_BLOCK_ADDR + 0x1000UL)
+#define IMAGE_STAGE_ADDR                (0xF10000UL)
+#define IMAGE_GOLDEN_ADDR               (0xF80000UL)
+#define IMAGE_SLOT_SIZE                 (0x70000UL)
+
+#define IMAGE_MANIFEST_MAGIC            (0x494D4731UL)
+/* stc_image_manifest_t::u32Pending, programmed from pending to installed in place */
+#define IMAGE_PENDING                   (0xFFFFFFFFUL)
+#define IMAGE_INSTALLED                 (0x00000000UL)
+/* stc_image_manifest_t::u32Confirmed, cleared once the image booted healthy */
+#define IMAGE_UNCONFIRMED               (0xFFFFFFFFUL)
+#define IMAGE_CONFIRMED                 (0x00000000UL)
+
+/*
+ * Boot attempt state in the last 16 bytes of Ret_SRAM, kept out of the
+ * linker RAM region. The application confirms a healthy start by writing
+ * IMAGE_BOOT_CONFIRM to u32Confirm, every boot.
+ */
+#define IMAGE_BOOT_STATE_ADDR           (0x200F0FF0UL)
+#define IMAGE_BOOT_STATE                ((stc_image_boot_state_t *)IMAGE_BOOT_STATE_ADDR)
+#define IMAGE_BOOT_MAGIC                (0x424F4F54UL)
+#define IMAGE_BOOT_CONFIRM              (0x600DB007UL)
+
+/* Unconfirmed boots of a new image before the golden image is restored */
+#ifndef IMAGE_BOOT_ATTEMPT_MAX
+#define IMAGE_BOOT_ATTEMPT_MAX          (3UL)
+#endif
+
+/* Bytes per W25Q read / EFM program step of the installer */
+#define IMAGE_COPY_CHUNK                (4096UL)
+
+/*******************************************************************************
+ * Global type definitions ('typedef')
+ ******************************************************************************/
+/**
+ * @brief Image manifest, the first bytes of a manifest sector.
+ * @note  u32HdrCrc covers the four words above it. The record is written
+ *        only after the whole image is staged.
+ */
+typedef struct {
+    uint32_t u32Magic;                  /*!< IMAGE_MANIFEST_MAGIC */
+    uint32_t u32Size;                   /*!< Image size in bytes */
+    uint32_t u32Version;                /*!< Image version, 0: unknown */
+    uint32_t u32Crc;                    /*!< CRC32 (IEEE 802.3) of the image */
+    uint32_t u32HdrCrc;                 /*!< CRC32 of the fields above */
+    uint32_t u32Pending;                /*!< IMAGE_PENDING or IMAGE_INSTALLED */
+    uint32_t u32Confirmed;              /*!< IMAGE_UNCONFIRMED or IMAGE_CONFIRMED */
+} stc_image_manifest_t;
+
+/**
+ * @brief Boot attempt state, survives resets but not a power loss.
+ */
+typedef struct {
+    __IO uint32_t u32Magic;             /*!< IMAGE_BOOT_MAGIC */
+    __IO uint32_t u32Attempts;          /*!< Unconfirmed boots of the installed image */
+    __IO uint32_t u32AttemptsInv;       /*!< ~u32Attempts */
+    __IO uint32_t u32Confirm;           /*!< IMAGE_BOOT_CONFIRM, written by the application */
+} stc_image_boot_state_t;
+
+/**
+ * @brief Staging writer.
+ */
+typedef struct {
+    uint32_t u32Size;                   /*!< Announced image size */
+    uint32_t u32Version;                /*!< Image version */
+    uint32_t u32Offset;                 /*!< Bytes staged so far */
+    uint32_t u32Crc;                    /*!< Running CRC32 */
+} stc_image_stage_t;
+
+/*******************************************************************************
+ * Global variable definitions ('extern')
+ ******************************************************************************/
+
+/*******************************************************************************
+  Global function prototypes (definition in C source)
+ ******************************************************************************/
+int32_t IMAGE_StageOpen(stc_image_stage_t *pstcStage, uint32_t u32Size, uint32_t u32Version);
+int32_t IMAGE_StageAppend(stc_image_stage_t *pstcStage, const uint8_t *pu8Buff, uint32_t u32Len);
+int32_t IMAGE_StageClose(stc_image_stage_t *pstcStage);
+
+int32_t IMAGE_ReadManifest(uint32_t u32Addr, stc_image_manifest_t *pstcManifest);
+int32_t IMAGE_InstallPending(void);
+int32_t IMAGE_BootCheck(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IMAGE_H__ */
+
+/*******************************************************************************
+ * EOF (not truncated)
+ ******************************************************************************/
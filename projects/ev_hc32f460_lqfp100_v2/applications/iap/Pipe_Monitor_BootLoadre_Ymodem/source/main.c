@@ -17,6 +17,7 @@
 #include "OLED.h"
 #include "Display.h"
 #include "W25Q128.h"
+#include "image.h"
 #include "string.h"
 #include "stdio.h"
 /*******************************************************************************
@@ -87,6 +88,28 @@ void SysTick_DeInit(void)
     SysTick->VAL   = 0UL;
 }
 
+/**
+ * @brief  Start the DWT cycle counter used for timing measurements.
+ * @param  None
+ * @retval None
+ */
+void IAP_CycleCounterInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0UL;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief  Get the DWT cycle counter.
+ * @param  None
+ * @retval Current HCLK cycle count
+ */
+uint32_t IAP_GetCycleCount(void)
+{
+    return DWT->CYCCNT;
+}
+
 /**
  * @brief  IAP clock initialize.
  *         Set board system clock to PLL@200MHz
@@ -178,6 +201,8 @@ void IAP_PeriphInit(void)
     /* Init Peripheral */
     IAP_CLK_Init();
     SysTick_Init(1000U);
+    IAP_CycleCounterInit();
+    FLASH_StatsLoad();
     COM_Init();
     
     EC200U_4G_Module_GPIO_Init();
@@ -221,6 +246,94 @@ void IAP_SendString(uint8_t *pu8Str)
 #endif
 }
 
+#if (FLASH_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Print the internal flash program speed (us per KB).
+ * @param  u32AppSize                   Size of the installed application
+ * @retval None
+ * @note   Uses the first sector past the application as scratch, nothing is
+ *         printed when the application fills the application area.
+ */
+void IAP_FlashBenchmark(uint32_t u32AppSize)
+{
+    uint32_t u32SingleUs = 0UL;
+    uint32_t u32SeqUs = 0UL;
+    uint32_t u32Addr;
+    char acStr[64];
+
+    if (u32AppSize > IAP_APP_SIZE) {
+        return;
+    }
+    u32Addr = IAP_APP_ADDR + u32AppSize;
+    if ((u32Addr % FLASH_SECTOR_SIZE) != 0UL) {
+        u32Addr += FLASH_SECTOR_SIZE - (u32Addr % FLASH_SECTOR_SIZE);
+    }
+    if (u32Addr >= (IAP_APP_ADDR + IAP_APP_SIZE)) {
+        return;
+    }
+
+    if (LL_OK == FLASH_Benchmark(u32Addr, &u32SingleUs, &u32SeqUs)) {
+        (void)sprintf(acStr, "\r\nFlash program: single %lu us/KB, sequence %lu us/KB\r\n",
+                      (unsigned long)u32SingleUs, (unsigned long)u32SeqUs);
+        IAP_SendString((uint8_t *)acStr);
+    }
+}
+#endif
+
+#if (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Print the cost of the YModem CRC16 engines (cycles per 1KB packet).
+ * @param  None
+ * @retval None
+ */
+void IAP_YModemCrcBenchmark(void)
+{
+    uint32_t u32BitCycle = 0UL;
+    uint32_t u32TableCycle = 0UL;
+    uint32_t u32HwCycle = 0UL;
+    int32_t i32Ret;
+    char acStr[96];
+
+    i32Ret = YModem_CrcBenchmark(&u32BitCycle, &u32TableCycle, &u32HwCycle);
+    if (LL_ERR_INVD_PARAM != i32Ret) {
+        (void)sprintf(acStr, "\r\nYModem CRC16: bitwise %lu, table %lu, hw %lu cycles/KB%s\r\n",
+                      (unsigned long)u32BitCycle, (unsigned long)u32TableCycle, (unsigned long)u32HwCycle,
+                      (LL_OK == i32Ret) ? "" : ", MISMATCH");
+        IAP_SendString((uint8_t *)acStr);
+    }
+}
+#endif
+
+#if (W25QXX_BENCH_ENABLE == DDL_ON)
+/**
+ * @brief  Print the W25Q128 read/program throughput (KB/s) of both SPI transports.
+ * @param  None
+ * @retval None
+ * @note   The scratch sector W25QXX_BENCH_ADDR is left erased.
+ */
+void IAP_SpiFlashBenchmark(void)
+{
+    static const uint8_t au8Trans[2U] = {BSP_W25QXX_TRANS_POLL, BSP_W25QXX_TRANS_DMA};
+    static const char *const apcName[2U] = {"poll", "dma"};
+    uint32_t u32ReadUs;
+    uint32_t u32ProgUs;
+    uint32_t i;
+    char acStr[80];
+
+    for (i = 0UL; i < 2UL; i++) {
+        u32ReadUs = 0UL;
+        u32ProgUs = 0UL;
+        if ((LL_OK == BSP_W25QXX_Benchmark(au8Trans[i], &u32ReadUs, &u32ProgUs)) &&
+            (u32ReadUs != 0UL) && (u32ProgUs != 0UL)) {
+            (void)sprintf(acStr, "\r\nW25Q %s: read %lu KB/s, program %lu KB/s\r\n", apcName[i],
+                          (unsigned long)((W25Q128_SECTOR_SIZE * 1000UL) / u32ReadUs),
+                          (unsigned long)((W25Q128_SECTOR_SIZE * 1000UL) / u32ProgUs));
+            IAP_SendString((uint8_t *)acStr);
+        }
+    }
+}
+#endif
+
 /**
  * @brief  Jump from boot to app function.
  * @param  [in] u32Addr                 APP address
@@ -431,11 +544,17 @@ int32_t main(void)
     BSP_W25QXX_Init();
     //读取FLASH中设备参数信息
 	BSP_W25QXX_Read(SYSTEM_PARA_ADDR,(uint8_t*)&gs_DevicePara.cDeviceID[0],sizeof(SysDeviceParaSt));
+#if (W25QXX_BENCH_ENABLE == DDL_ON)
+    IAP_SpiFlashBenchmark();
+#endif
+#if (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+    IAP_YModemCrcBenchmark();
+#endif
 
-    //OLED初始化
-    drv_OLED_Init();
-    //OLED_Test(1);
-    func_Device_Starting_View_Show(9,9,9);
+    //OLED不在此初始化: 直接跳转APP时面板保持关闭, 首个升级界面时由界面服务上电
+    func_UI_Post_Phase(UI_PHASE_STARTING);
+    //安装应用程序已下载到W25Q128暂存区的镜像
+    (void)IMAGE_InstallPending();
     //DDL_DelayMS(1000);
     uc4GInitFlag = EC200U_4G_Module_Init();
     func_WatchDog_Refresh();
@@ -512,21 +631,30 @@ int32_t main(void)
     {
         //IAP_SendString((uint8_t *)"\r\nEnter download mode \r\n");
         //YModem_Download();
-        func_Device_Upgrade_View_Show();
+        func_UI_Post_Phase(UI_PHASE_UPGRADE);
+        func_UI_Flush();
         ucUpdateFlag = func_4G_Module_Connect_HTTP(guc_URLArr, gus_URLArrLen, gul_UpdateFileSize); //获取升级文件
-        func_Device_UpgradeResult_View_Show(ucUpdateFlag);
+        func_UI_Post_Result(ucUpdateFlag);
+        func_UI_Flush();
         func_4G_Up_Upgrade_Result(ucUpdateFlag);
         if(ucUpdateFlag != 0)
         {
+            func_UI_Panel_Off();
             IAP_PeriphDeinit();
             func_System_Soft_Reset();    //软件复位
         }
+#if (FLASH_BENCH_ENABLE == DDL_ON)
+        IAP_FlashBenchmark(gul_IAP_Upgrade_Total_Size);   //新程序之后的空闲扇区
+#endif
     }
     func_WatchDog_Refresh();
+    (void)IMAGE_BootCheck();    //启动计数，新程序未确认则回滚到备份镜像
+    func_UI_Panel_Off();        //APP自行初始化OLED
     IAP_PeriphDeinit();
     func_WatchDog_Refresh();
     if (LL_OK != IAP_JumpToApp(IAP_APP_ADDR)) 
     {
+        func_OLED_PowerUp_Init();
         OLED_Test(2);
         DDL_DelayMS(1000);
         IAP_SendString((uint8_t *)"\r\nJump to app failed \r\n");
@@ -133,6 +133,21 @@ extern unsigned char guc_TestCnt;
 
 extern void func_WatchDog_Refresh(void);
 
+/* HCLK cycles to microseconds */
+#define IAP_CYCLE_TO_US(x)              ((x) / (HCLK_VALUE / 1000000UL))
+
+extern void IAP_CycleCounterInit(void);
+extern uint32_t IAP_GetCycleCount(void);
+#if (FLASH_BENCH_ENABLE == DDL_ON)
+extern void IAP_FlashBenchmark(uint32_t u32AppSize);
+#endif
+#if (W25QXX_BENCH_ENABLE == DDL_ON)
+extern void IAP_SpiFlashBenchmark(void);
+#endif
+#if (YMODEM_CRC_BENCH_ENABLE == DDL_ON)
+extern void IAP_YModemCrcBenchmark(void);
+#endif
+
 #endif /* __MAIN_H__ */
 
 /*******************************************************************************
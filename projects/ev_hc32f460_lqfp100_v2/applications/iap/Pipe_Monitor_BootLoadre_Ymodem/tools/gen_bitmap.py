@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""
+Pre-render the constant UI strings into page-aligned bitmaps.
+
+Reads the glyph tables in source/Font.c, lays out every string listed in
+LAYOUT exactly as func_display_string() would draw it, and writes
+source/Bitmap.c and source/Bitmap.h. Only the digits of the 16x10 font
+are emitted as a glyph table, they are the only characters still
+composed at runtime (func_display_digit()).
+
+Run from anywhere after changing Font.c or LAYOUT:
+    python tools/gen_bitmap.py
+
+With --pbm DIR the views in VIEWS are also composed the way Display.c
+draws them and written to DIR as 128x64 PBM images, for reviewing UI
+changes without a board. tools/host_display/golden holds these images as
+the reference for tools/host_display/run.sh, which renders the views with
+the real Display.c/OLED.c code on the host.
+"""
+import argparse
+import os
+import re
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir)
+FONT_C = os.path.join(ROOT, "source", "Font.c")
+OUT_C = os.path.join(ROOT, "source", "Bitmap.c")
+OUT_H = os.path.join(ROOT, "source", "Bitmap.h")
+
+PAGE_NUM = 8
+COLUMN_NUM = 128
+
+# name, X_dot, Y_dot, glyph codes as passed to func_display_string()
+LAYOUT = [
+    ("STARTING",        0, 30, [0x000F, 0x0010, 0x002B, 0x002C, 0x002D, 0x0532, 0x0532, 0x0532]),
+    ("UPGRADE_TITLE",   0, 30, [0x000F, 0x0010, 0x002E, 0x002F, 0x002D]),
+    ("UPGRADE_PERCENT", 80, 30, [0x0528, 0x0532, 0x0532, 0x0532]),
+    ("UPGRADE_OK",      0, 30, [0x000F, 0x0010, 0x002E, 0x002F, 0x0030, 0x0031]),
+    ("UPGRADE_FAIL",    0, 30, [0x000F, 0x0010, 0x002E, 0x002F, 0x0032, 0x0033]),
+]
+
+# view name, LAYOUT strings, (X_dot, Y_dot, digit) drawn by func_display_digit()
+VIEWS = [
+    ("starting",        ["STARTING"], []),
+    ("upgrade",         ["UPGRADE_TITLE", "UPGRADE_PERCENT"], [(60, 30, 4), (70, 30, 2), (108, 48, 2), (118, 48, 3)]),
+    ("upgrade_ok",      ["UPGRADE_OK"], []),
+    ("upgrade_fail",    ["UPGRADE_FAIL"], []),
+]
+
+
+def load_font(text, name, row_len):
+    m = re.search(r"const\s+signed\s+char\s+" + name + r"\s*\[\d+\]\s*\[\d+\]\s*=\s*\{(.*?)\};", text, re.S)
+    body = re.sub(r"//[^\n]*|/\*.*?\*/", "", m.group(1), flags=re.S)
+    rows = []
+    for row in re.findall(r"\{([^{}]*)\}", body):
+        vals = [int(v, 16) for v in re.findall(r"0[xX][0-9a-fA-F]+", row)]
+        rows.append(vals + [0] * (row_len - len(vals)))
+    return rows
+
+
+def glyph_columns(fonts, code):
+    """Return the glyph as a list of (column bits, clear mask) pairs."""
+    size, idx = (code >> 8) & 0xFF, code & 0xFF
+    if size == 0:                           # 16x12 Chinese, ORed in
+        g = fonts["cn"][idx]
+        return [(g[j * 2] | (g[j * 2 + 1] << 8), 0) for j in range(12)]
+    if size == 5:                           # 16x10 digits and letters
+        width = 4 if idx in (0x32, 0x33) else 7 if idx == 0x46 else 10
+        g = fonts["dg"][idx]
+        cols = []
+        for j in range(width):
+            v = g[j * 2] | (g[j * 2 + 1] << 8)
+            if idx < 0x45 or idx > 0x4B:
+                v >>= 2
+            cols.append((v, 0x3FFF))
+        return cols
+    raise ValueError("glyph size %d is not supported" % size)
+
+
+def render(fonts, x, y, codes):
+    buf = [[0] * PAGE_NUM for _ in range(COLUMN_NUM)]
+    for code in codes:
+        for bits, clear in glyph_columns(fonts, code):
+            bits <<= y % 8
+            clear <<= y % 8
+            for p in range(3):
+                page = y // 8 + p
+                if page < PAGE_NUM:
+                    byte = buf[x][page] & ~((clear >> (8 * p)) & 0xFF)
+                    buf[x][page] = byte | ((bits >> (8 * p)) & 0xFF)
+            x += 1
+    return buf
+
+
+def crop(buf):
+    cells = [(c, p) for c in range(COLUMN_NUM) for p in range(PAGE_NUM) if buf[c][p]]
+    c0 = min(c for c, _ in cells)
+    c1 = max(c for c, _ in cells)
+    p0 = min(p for _, p in cells)
+    p1 = max(p for _, p in cells)
+    data = [buf[c][p] for p in range(p0, p1 + 1) for c in range(c0, c1 + 1)]
+    return c0, p0, c1 - c0 + 1, p1 - p0 + 1, data
+
+
+def write_pbm(path, buf):
+    rows = []
+    for y in range(PAGE_NUM * 8):
+        bits = [(buf[x][y // 8] >> (y % 8)) & 1 for x in range(COLUMN_NUM)]
+        rows.append(bytes(int("".join(map(str, bits[i:i + 8])), 2) for i in range(0, COLUMN_NUM, 8)))
+    with open(path, "wb") as f:
+        f.write(b"P4\n%d %d\n" % (COLUMN_NUM, PAGE_NUM * 8) + b"".join(rows))
+
+
+def compose(fonts, strings, digits):
+    layout = dict((name, (x, y, codes)) for name, x, y, codes in LAYOUT)
+    buf = [[0] * PAGE_NUM for _ in range(COLUMN_NUM)]
+    for name in strings:
+        part = render(fonts, *layout[name])
+        for c in range(COLUMN_NUM):
+            for p in range(PAGE_NUM):
+                buf[c][p] |= part[c][p]
+    for x, y, d in digits:
+        part = render(fonts, x, y, [0x0500 | d])
+        for c in range(COLUMN_NUM):
+            for p in range(PAGE_NUM):
+                buf[c][p] |= part[c][p]
+    return buf
+
+
+def hex_rows(vals, fmt, per_line):
+    lines = []
+    for i in range(0, len(vals), per_line):
+        lines.append("\t" + ",".join(fmt % v for v in vals[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--pbm", metavar="DIR", help="also write the composed views as PBM images")
+    args = parser.parse_args()
+
+    text = open(FONT_C, encoding="utf-8", errors="replace").read()
+    fonts = {
+        "dg": load_font(text, "g_sint8_Font_16x10_12864", 20),
+        "cn": load_font(text, "g_sint8_Font_16x12_12864", 24),
+    }
+
+    c_out = []
+    h_out = []
+    for name, x, y, codes in LAYOUT:
+        col, page, width, pages, data = crop(render(fonts, x, y, codes))
+        ident = "g_stBitmap_" + "".join(w.capitalize() for w in name.split("_"))
+        c_out.append("static const unsigned char m_auc%sData[%d] =\n{\n%s\n};\n" %
+                     (ident[11:], len(data), hex_rows(data, "0x%02X", 16)))
+        c_out.append("const BitmapSt %s = {%d, %d, %d, %d, m_auc%sData};\n" %
+                     (ident, col, page, width, pages, ident[11:]))
+        h_out.append("extern const BitmapSt %s;\t//(%d,%d) %s" %
+                     (ident, x, y, " ".join("%04X" % c for c in codes)))
+
+    digits = [[bits for bits, _ in glyph_columns(fonts, 0x0500 | d)] for d in range(10)]
+    c_out.append("const unsigned short g_ausBitmap_Digit_16x10[10][10] =\n{\n%s\n};\n" %
+                 "\n".join("\t{" + ",".join("0x%04X" % v for v in row) + "},\t// '%d'" % d
+                           for d, row in enumerate(digits)))
+
+    with open(OUT_C, "w", encoding="utf-8", newline="\n") as f:
+        f.write(C_TEMPLATE % "\n".join(c_out))
+    with open(OUT_H, "w", encoding="utf-8", newline="\n") as f:
+        f.write(H_TEMPLATE % "\n".join(h_out))
+
+    if args.pbm:
+        os.makedirs(args.pbm, exist_ok=True)
+        for name, strings, digits in VIEWS:
+            write_pbm(os.path.join(args.pbm, name + ".pbm"), compose(fonts, strings, digits))
+
+
+H_TEMPLATE = """/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\\source\\Bitmap.h
+ * @brief Pre-rendered UI strings, generated by tools/gen_bitmap.py from Font.c.
+ *        Do not edit.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-05-06       Joe             First version
+ @endverbatim
+
+ */
+#ifndef __BITMAP_H__
+#define __BITMAP_H__
+
+/* C binding of definitions if building with C++ compiler */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Global pre-processor symbols/macros ('#define')
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Global type definitions ('typedef')
+ ******************************************************************************/
+//按页对齐的位图, 字符串已按显示位置(含 Y 方向位偏移)渲染
+typedef struct
+{
+	unsigned char ucColumn;		//起始列
+	unsigned char ucPage;		//起始页
+	unsigned char ucWidth;		//列数
+	unsigned char ucPages;		//页数
+	const unsigned char *pucData;	//按页存放, 每页 ucWidth 字节
+} BitmapSt;
+
+/*******************************************************************************
+ * Global variable definitions ('extern')
+ ******************************************************************************/
+%s
+
+//16x10 字体数字 '0'..'9', 每列14位, 最低位为字符顶行
+extern const unsigned short g_ausBitmap_Digit_16x10[10][10];
+
+/*******************************************************************************
+  Global function prototypes (definition in C source)
+ ******************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BITMAP_H__ */
+
+/*******************************************************************************
+ * EOF (not truncated)
+ ******************************************************************************/
+"""
+
+C_TEMPLATE = """/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\\source\\Bitmap.c
+ * @brief Pre-rendered UI strings, generated by tools/gen_bitmap.py from Font.c.
+ *        Do not edit.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-05-06       Joe             First version
+ @endverbatim
+
+ */
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+#include "Bitmap.h"
+
+/*******************************************************************************
+ * Global variable definitions (declared in header file with 'extern')
+ ******************************************************************************/
+%s
+/******************************************************************************
+ *
+ * EOF (not truncated)
+ *****************************************************************************/
+"""
+
+if __name__ == "__main__":
+    main()
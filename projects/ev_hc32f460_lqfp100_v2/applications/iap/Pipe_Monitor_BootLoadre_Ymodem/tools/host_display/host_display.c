@@ -0,0 +1,281 @@
+/**
+ *******************************************************************************
+ * @file  Pipe_Monitor_BootLoader\tools\host_display\host_display.c
+ * @brief Host build of Display.c, OLED.c, Font.c and Bitmap.c. Every view is
+ *        rendered through the real framebuffer and dirty-span flush code into
+ *        a model of the panel GRAM, compared against the golden PBMs written
+ *        by tools/gen_bitmap.py, and timed. Built and run by run.sh.
+ @verbatim
+   Change Logs:
+   Date             Author          Notes
+   2025-05-06       Joe             First version
+ @endverbatim
+
+ */
+
+/*******************************************************************************
+ * Include files
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "OLED.h"
+#include "Display.h"
+#include "hc32_ll_utility.h"
+
+#if (OLED_TRANS != OLED_TRANS_HOST)
+#error "Build with -DOLED_TRANS=OLED_TRANS_HOST"
+#endif
+
+/*******************************************************************************
+ * Local type definitions ('typedef')
+ ******************************************************************************/
+typedef struct {
+    const char *pcName;                 /* Golden file name without .pbm */
+    void (*pfnShow)(unsigned long ulStep);  /* Draw the view, ulStep varies the data */
+} stc_host_view_t;
+
+/*******************************************************************************
+ * Local pre-processor symbols/macros ('#define')
+ ******************************************************************************/
+#define HOST_COLUMN_NUM                 (128U)
+#define HOST_PAGE_NUM                   (8U)
+#define HOST_ROW_NUM                    (HOST_PAGE_NUM * 8U)
+#define HOST_PBM_SIZE                   ((HOST_COLUMN_NUM / 8U) * HOST_ROW_NUM)
+
+/* Redraws per view in the timing loop */
+#define HOST_TIMING_LOOPS               (20000UL)
+
+/*******************************************************************************
+ * Local function prototypes ('static')
+ ******************************************************************************/
+static void HOST_ShowStarting(unsigned long ulStep);
+static void HOST_ShowUpgrade(unsigned long ulStep);
+static void HOST_ShowUpgradeOk(unsigned long ulStep);
+static void HOST_ShowUpgradeFail(unsigned long ulStep);
+
+/*******************************************************************************
+ * Local variable definitions ('static')
+ ******************************************************************************/
+static uint8_t m_au8Panel[HOST_PAGE_NUM][HOST_COLUMN_NUM];  /* Panel GRAM model */
+static unsigned long m_ulPanelBytes = 0UL;  /* Data bytes sent to the panel */
+static unsigned long m_ulPanelErrors = 0UL; /* Page writes outside the panel */
+static uint32_t m_u32Tick = 0UL;
+
+/* Same views and data as VIEWS in tools/gen_bitmap.py */
+static const stc_host_view_t m_astViews[] = {
+    {"starting",     HOST_ShowStarting},
+    {"upgrade",      HOST_ShowUpgrade},
+    {"upgrade_ok",   HOST_ShowUpgradeOk},
+    {"upgrade_fail", HOST_ShowUpgradeFail},
+};
+
+/*******************************************************************************
+ * Function implementation - global ('extern') and local ('static')
+ ******************************************************************************/
+/* Panel transport, called by OLED_Write_Page() */
+void OLED_Host_Write_Page(uint8_t ucPage, uint8_t ucColumn, const uint8_t *pu8Data, uint8_t ucLen)
+{
+    if ((ucPage >= HOST_PAGE_NUM) || (((uint32_t)ucColumn + ucLen) > HOST_COLUMN_NUM)) {
+        m_ulPanelErrors++;
+        return;
+    }
+    memcpy(&m_au8Panel[ucPage][ucColumn], pu8Data, ucLen);
+    m_ulPanelBytes += ucLen;
+}
+
+/* LL stubs: pins go nowhere, delays advance the tick */
+uint32_t SysTick_GetTick(void)
+{
+    return m_u32Tick;
+}
+
+void DDL_DelayMS(uint32_t u32Count)
+{
+    m_u32Tick += u32Count;
+}
+
+void DDL_DelayUS(uint32_t u32Count)
+{
+    (void)u32Count;
+}
+
+int32_t GPIO_Init(uint8_t u8Port, uint16_t u16Pin, const stc_gpio_init_t *pstcGpioInit)
+{
+    (void)u8Port;
+    (void)u16Pin;
+    (void)pstcGpioInit;
+    return LL_OK;
+}
+
+int32_t GPIO_StructInit(stc_gpio_init_t *pstcGpioInit)
+{
+    memset(pstcGpioInit, 0, sizeof(*pstcGpioInit));
+    return LL_OK;
+}
+
+en_pin_state_t GPIO_ReadInputPins(uint8_t u8Port, uint16_t u16Pin)
+{
+    (void)u8Port;
+    (void)u16Pin;
+    return PIN_RESET;
+}
+
+void GPIO_SetPins(uint8_t u8Port, uint16_t u16Pin)
+{
+    (void)u8Port;
+    (void)u16Pin;
+}
+
+void GPIO_ResetPins(uint8_t u8Port, uint16_t u16Pin)
+{
+    (void)u8Port;
+    (void)u16Pin;
+}
+
+static void HOST_ShowStarting(unsigned long ulStep)
+{
+    (void)ulStep;
+    func_Device_Starting_View_Show(0U, 0U, 0U);
+}
+
+/* Step 0 is the golden frame (42%, rssi 23), later steps walk the percent */
+static void HOST_ShowUpgrade(unsigned long ulStep)
+{
+    func_UI_Post_Progress((42UL + ulStep) % 100UL, 100UL);
+    func_UI_Post_Rssi(23U);
+    func_Device_Upgrade_View_Show();
+}
+
+static void HOST_ShowUpgradeOk(unsigned long ulStep)
+{
+    (void)ulStep;
+    func_Device_UpgradeResult_View_Show(0U);
+}
+
+static void HOST_ShowUpgradeFail(unsigned long ulStep)
+{
+    (void)ulStep;
+    func_Device_UpgradeResult_View_Show(1U);
+}
+
+/* Pack a page-major frame into P4 rows, MSB is the leftmost pixel */
+static void HOST_FrameToPbm(const uint8_t au8Frame[HOST_PAGE_NUM][HOST_COLUMN_NUM], uint8_t *pu8Pbm)
+{
+    uint32_t u32Row, u32Col;
+
+    memset(pu8Pbm, 0, HOST_PBM_SIZE);
+    for (u32Row = 0UL; u32Row < HOST_ROW_NUM; u32Row++) {
+        for (u32Col = 0UL; u32Col < HOST_COLUMN_NUM; u32Col++) {
+            if (((au8Frame[u32Row / 8U][u32Col] >> (u32Row % 8U)) & 1U) != 0U) {
+                pu8Pbm[(u32Row * (HOST_COLUMN_NUM / 8U)) + (u32Col / 8U)] |= (uint8_t)(0x80U >> (u32Col % 8U));
+            }
+        }
+    }
+}
+
+static int HOST_ReadPbm(const char *pcPath, uint8_t *pu8Pbm)
+{
+    FILE *pFile;
+    int iWidth = 0;
+    int iHeight = 0;
+    int iRet = -1;
+
+    pFile = fopen(pcPath, "rb");
+    if (pFile == NULL) {
+        return -1;
+    }
+    if ((fscanf(pFile, "P4 %d %d", &iWidth, &iHeight) == 2) && (fgetc(pFile) != EOF) &&
+        (iWidth == (int)HOST_COLUMN_NUM) && (iHeight == (int)HOST_ROW_NUM) &&
+        (fread(pu8Pbm, 1U, HOST_PBM_SIZE, pFile) == HOST_PBM_SIZE)) {
+        iRet = 0;
+    }
+    (void)fclose(pFile);
+
+    return iRet;
+}
+
+static void HOST_WritePbm(const char *pcPath, const uint8_t *pu8Pbm)
+{
+    FILE *pFile;
+
+    pFile = fopen(pcPath, "wb");
+    if (pFile != NULL) {
+        (void)fprintf(pFile, "P4\n%u %u\n", HOST_COLUMN_NUM, HOST_ROW_NUM);
+        (void)fwrite(pu8Pbm, 1U, HOST_PBM_SIZE, pFile);
+        (void)fclose(pFile);
+    }
+}
+
+/**
+ * @brief  Render, check and time every view.
+ * @param  argv[1]                      Directory of the golden PBMs
+ * @param  argv[2]                      Optional directory for the rendered PBMs
+ * @retval 0 when every view matches its golden image
+ */
+int main(int argc, char *argv[])
+{
+    uint8_t au8Golden[HOST_PBM_SIZE];
+    uint8_t au8Render[HOST_PBM_SIZE];
+    char acPath[512];
+    struct timespec stStart, stEnd;
+    unsigned long ulBytes, ulStep;
+    double dNs;
+    size_t i;
+    int iFail = 0;
+
+    if (argc < 2) {
+        (void)fprintf(stderr, "usage: %s GOLDEN_DIR [OUT_DIR]\n", argv[0]);
+        return 2;
+    }
+
+    /* Panel content starts unknown, the first flush sends the whole screen */
+    memset(m_au8Panel, 0xA5, sizeof(m_au8Panel));
+    (void)printf("%-14s %-6s %12s %12s %14s\n", "view", "golden", "first bytes", "ns/redraw", "bytes/redraw");
+    for (i = 0U; i < (sizeof(m_astViews) / sizeof(m_astViews[0])); i++) {
+        /* Golden frame, flushed as a diff against the previous view */
+        ulBytes = m_ulPanelBytes;
+        m_astViews[i].pfnShow(0UL);
+        ulBytes = m_ulPanelBytes - ulBytes;
+        HOST_FrameToPbm((const uint8_t (*)[HOST_COLUMN_NUM])m_au8Panel, au8Render);
+        if (argc > 2) {
+            (void)snprintf(acPath, sizeof(acPath), "%s/%s.pbm", argv[2], m_astViews[i].pcName);
+            HOST_WritePbm(acPath, au8Render);
+        }
+        (void)snprintf(acPath, sizeof(acPath), "%s/%s.pbm", argv[1], m_astViews[i].pcName);
+        if (HOST_ReadPbm(acPath, au8Golden) != 0) {
+            (void)printf("%-14s %-6s\n", m_astViews[i].pcName, "none");
+            iFail = 1;
+            continue;
+        }
+        if (memcmp(au8Golden, au8Render, HOST_PBM_SIZE) != 0) {
+            iFail = 1;
+        }
+
+        /* Redraw timing, the panel must still track the framebuffer afterwards */
+        (void)clock_gettime(CLOCK_MONOTONIC, &stStart);
+        m_ulPanelBytes = 0UL;
+        for (ulStep = 1UL; ulStep <= HOST_TIMING_LOOPS; ulStep++) {
+            m_astViews[i].pfnShow(ulStep);
+        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &stEnd);
+        dNs = ((double)(stEnd.tv_sec - stStart.tv_sec) * 1e9) + (double)(stEnd.tv_nsec - stStart.tv_nsec);
+        (void)printf("%-14s %-6s %12lu %12.0f %14.1f\n", m_astViews[i].pcName,
+                     (memcmp(au8Golden, au8Render, HOST_PBM_SIZE) == 0) ? "ok" : "DIFF", ulBytes,
+                     dNs / (double)HOST_TIMING_LOOPS, (double)m_ulPanelBytes / (double)HOST_TIMING_LOOPS);
+        if (memcmp(m_au8Panel, guc_OLED_Buf, sizeof(m_au8Panel)) != 0) {
+            (void)printf("%-14s panel does not match guc_OLED_Buf after the timing loop\n", m_astViews[i].pcName);
+            iFail = 1;
+        }
+    }
+    if (m_ulPanelErrors != 0UL) {
+        (void)printf("%lu page writes outside the panel\n", m_ulPanelErrors);
+        iFail = 1;
+    }
+
+    return iFail;
+}
+
+/*******************************************************************************
+ * EOF (not truncated)
+ ******************************************************************************/
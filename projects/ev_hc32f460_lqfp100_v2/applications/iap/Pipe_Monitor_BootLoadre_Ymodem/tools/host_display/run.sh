@@ -0,0 +1,24 @@
+#!/bin/sh
+# Build the display sources for the host and check every view against the
+# golden PBMs. Extra arguments are passed on, e.g. an output directory for the
+# rendered PBMs:
+#     tools/host_display/run.sh /tmp/views
+# Regenerate the golden images after an intended UI change with:
+#     python tools/gen_bitmap.py --pbm tools/host_display/golden
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+APP=$HERE/../..
+ROOT=$APP/../../../../..
+CC=${CC:-cc}
+OUT=${TMPDIR:-/tmp}/host_display.$$
+
+trap 'rm -f "$OUT"' EXIT
+$CC -std=gnu99 -O2 -Wall -Wno-unused-function -Wno-unused-variable -Wno-unused-but-set-variable \
+    -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast \
+    -DHC32F460 -DUSE_DDL_DRIVER -DOLED_TRANS=OLED_TRANS_HOST \
+    -I"$APP/source" -I"$APP/drv_device/4G_EC200U" -I"$APP/drv_device/W25Q128" \
+    -I"$ROOT/drivers/cmsis/Device/HDSC/hc32f4xx/Include" -I"$ROOT/drivers/cmsis/Include" \
+    -I"$ROOT/drivers/hc32_ll_driver/inc" -I"$ROOT/midwares/hc32/iap/ymodem" \
+    -o "$OUT" "$HERE/host_display.c" \
+    "$APP/source/Display.c" "$APP/source/OLED.c" "$APP/source/Font.c" "$APP/source/Bitmap.c" -lm
+"$OUT" "$HERE/golden" "$@"